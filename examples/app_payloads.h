@@ -0,0 +1,22 @@
+#ifndef APP_PAYLOADS_H
+#define APP_PAYLOADS_H
+
+#include <stdint.h>
+
+// 网络连接信息（APP_EVENT_LINK_UP 负载）
+typedef struct 
+{
+    uint32_t ip_addr;
+    uint16_t mtu;
+    uint8_t rssi;
+    uint8_t reserved;
+} link_info_t;
+
+// 传感器采样（APP_EVENT_SENSOR_SAMPLE 负载）
+typedef struct 
+{
+    int32_t value;
+    uint32_t seq;
+} sensor_sample_t;
+
+#endif
@@ -1,9 +1,11 @@
 #include "eventhub.h"
+#include "eventhub_coro.h"
 #include "FreeRTOS.h"
 #include "task.h"
 
 // 事件类型
 #define EVENT_VCC_POWER_ON 1
+#define EVENT_LINK_UP 2
 
 // 全局事件中枢
 static eventhub_t g_hub;
@@ -17,6 +19,26 @@ void network_callback(const eventhub_event_t* event, void* user_data)
     }
 }
 
+// 协程订阅者：等待VCC打开，再等待网络连接（5秒超时），无需独立任务和栈
+static eventhub_coro_t g_link_coro;
+
+static EVENTHUB_CORO(link_monitor_coro)
+{
+    EVENTHUB_CORO_BEGIN();
+    EVENTHUB_AWAIT(EVENT_VCC_POWER_ON, EVENTHUB_WAIT_FOREVER);
+    printf("Link monitor: VCC ON, waiting for link...\n");
+    EVENTHUB_AWAIT(EVENT_LINK_UP, 5000);
+    if (EVENTHUB_CORO_TIMED_OUT()) 
+    {
+        printf("Link monitor: link up timeout\n");
+    }
+    else 
+    {
+        printf("Link monitor: link up\n");
+    }
+    EVENTHUB_CORO_END();
+}
+
 // 事件处理任务（RTOS环境必须）
 void event_process_task(void* param) 
 {
@@ -52,6 +74,7 @@ int main(void)
 
     // 订阅事件
     eventhub_subscribe(&g_hub, EVENT_VCC_POWER_ON, network_callback, NULL);
+    eventhub_coro_start(&g_hub, &g_link_coro, link_monitor_coro, NULL);
 
     // 创建任务
     xTaskCreate(event_process_task, "event_process", 512, NULL, 3, NULL);
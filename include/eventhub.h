@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "eventhub_config.h"
 #include "eventhub_port.h"
 
@@ -18,19 +19,150 @@ typedef struct
     uint32_t data_len;                   // 附加数据长度
 } eventhub_event_t;
 
+// 事件类型属性标志（通常由 tools/eventhub_gen.py 根据事件模式文件生成）
+#define EVENTHUB_TYPE_FLAG_DEFINED   (1U << 0)  // 该类型已在属性表中定义，发布时校验负载长度
+#define EVENTHUB_TYPE_FLAG_RETAINED  (1U << 1)  // 保留最近一次事件，新订阅者订阅时立即收到
+#define EVENTHUB_TYPE_FLAG_COALESCED (1U << 2)  // 队列中已有同类型待处理事件时用新事件覆盖它，订阅者收到最新值（仅RTOS环境有效）
+#define EVENTHUB_TYPE_FLAG_PRIORITY  (1U << 3)  // 插入队列头部优先处理（仅RTOS环境有效）
+
+// 未分配策略槽的类型
+#define EVENTHUB_TYPE_NO_SLOT 0xFF
+
+// 事件类型属性（按事件类型下标索引的常量表，常驻Flash）
+typedef struct 
+{
+    uint16_t payload_size;               // 负载结构体大小（0=无负载）
+    uint8_t flags;                       // EVENTHUB_TYPE_FLAG_* 组合
+    uint8_t slot;                        // 保留/合并策略槽下标（EVENTHUB_TYPE_NO_SLOT=无）
+} eventhub_type_props_t;
+
 // 订阅者回调函数原型
 typedef void (*eventhub_subscriber_cb)(const eventhub_event_t* event, void* user_data);
 
-// 模块订阅者结构体
+// 模块订阅者结构体（订阅的事件类型记录在中枢的订阅位图中）
 typedef struct 
 {
     eventhub_subscriber_cb cb;
     void* user_data;
-    uint32_t event_mask[EVENT_MASK_WORDS];  // 位图数组表示该模块订阅的所有事件类型
+    uint32_t ref_count;                  // 精确订阅的类型数 + 范围订阅数，归零时释放模块
     bool in_use;
 } eventhub_module_subscriber_t;
 
-// 事件中枢句柄（用户无需关心内部结构）
+// 范围订阅项（区间存储，不展开到位图）
+typedef struct 
+{
+    eventhub_event_type_t first;         // 起始事件类型（含）
+    eventhub_event_type_t last;          // 结束事件类型（含）
+    eventhub_event_type_t covered_end;   // 同一模块排在前面的范围已覆盖的类型上界（不含，0=无）
+    uint16_t module;                     // 所属模块订阅者下标
+} eventhub_range_subscriber_t;
+
+// 范围订阅分发游标（分发期间位于调用栈上，回调中增删范围订阅时据此修正待分发的下标）
+typedef struct eventhub_range_cursor 
+{
+    uint16_t next;                       // 下一个待分发的范围订阅项下标
+    struct eventhub_range_cursor* outer; // 外层（回调中发布引起的嵌套分发）的游标
+} eventhub_range_cursor_t;
+
+// 分组对应的事件类型范围
+#define EVENTHUB_GROUP_FIRST(group) ((eventhub_event_type_t)(group) << EVENTHUB_GROUP_BITS)
+#define EVENTHUB_GROUP_LAST(group)  (EVENTHUB_GROUP_FIRST((group) + 1) - 1)
+
+// 协程等待超时：永不超时
+#define EVENTHUB_WAIT_FOREVER 0xFFFFFFFFU
+
+// 协程执行状态
+typedef enum 
+{
+    EVENTHUB_CORO_WAITING = 0,           // 挂起，等待事件或超时
+    EVENTHUB_CORO_DONE                   // 执行结束，自动从中枢移除
+} eventhub_coro_status_t;
+
+typedef struct eventhub_coro eventhub_coro_t;
+
+// 协程函数原型（建议用 eventhub_coro.h 中的 EVENTHUB_CORO 宏定义）
+typedef eventhub_coro_status_t (*eventhub_coro_fn)(eventhub_coro_t* co, const eventhub_event_t* event, void* user_data);
+
+// 无栈协程状态（调用者静态分配，挂起期间局部变量不保留）
+struct eventhub_coro 
+{
+    eventhub_coro_fn fn;
+    void* user_data;
+    eventhub_event_type_t wait_type;     // 正在等待的事件类型
+    eventhub_timestamp_t deadline;       // 等待截止时间（毫秒时间戳）
+    uint32_t retained_stamp;             // 最近一次收到的保留事件的序号（避免重复恢复）
+    uint16_t lc;                         // 续点（恢复执行的行号）
+    uint8_t has_deadline;                // 是否设置了超时
+    uint8_t timed_out;                   // 最近一次恢复是否因超时
+};
+
+// 事件中枢容量配置（运行时指定，每个中枢可不同）
+typedef struct 
+{
+    uint16_t max_modules;                // 最大模块订阅者数量
+    uint16_t queue_size;                 // 事件队列深度（仅RTOS环境有效）
+    uint32_t max_event_types;            // 事件类型空间（有效类型为0 ~ max_event_types-1）
+    uint16_t max_range_subs;             // 范围/分组订阅表容量
+    uint16_t max_coros;                  // 最大协程订阅者数量
+    uint8_t max_type_slots;              // 保留/合并策略槽数量
+} eventhub_config_t;
+
+// 按eventhub_config.h中的宏生成的默认配置（eventhub_init使用）
+#define EVENTHUB_CONFIG_DEFAULT \
+    { \
+        EVENTHUB_MAX_MODULES, EVENTHUB_QUEUE_SIZE, EVENTHUB_MAX_EVENT_TYPES, \
+        EVENTHUB_MAX_RANGE_SUBS, EVENTHUB_MAX_COROS, EVENTHUB_MAX_TYPE_SLOTS \
+    }
+
+// 内存区对齐要求（各张表均按此对齐，调用者提供的内存区首地址也需满足）
+#define EVENTHUB_ARENA_ALIGN 8
+#define EVENTHUB_ARENA_ROUND(n) (((size_t)(n) + EVENTHUB_ARENA_ALIGN - 1) & ~(size_t)(EVENTHUB_ARENA_ALIGN - 1))
+
+// 订阅位图每行的字数（每行对应一个事件类型，每位对应一个模块）
+#define EVENTHUB_MODULE_WORDS(max_modules) (((max_modules) + EVENT_MASK_BITS_PER_WORD - 1) / EVENT_MASK_BITS_PER_WORD)
+
+// 内存区中各张表的大小（按分发时访问频率排列）
+#define EVENTHUB_ARENA_BITMAP_SIZE(max_modules, max_event_types) \
+    EVENTHUB_ARENA_ROUND((size_t)(max_event_types) * EVENTHUB_MODULE_WORDS(max_modules) * sizeof(uint32_t))
+#define EVENTHUB_ARENA_MODULES_SIZE(max_modules) \
+    EVENTHUB_ARENA_ROUND((size_t)(max_modules) * sizeof(eventhub_module_subscriber_t))
+#define EVENTHUB_ARENA_RANGES_SIZE(max_range_subs) \
+    EVENTHUB_ARENA_ROUND((size_t)(max_range_subs) * sizeof(eventhub_range_subscriber_t))
+#define EVENTHUB_ARENA_COROS_SIZE(max_coros) \
+    EVENTHUB_ARENA_ROUND((size_t)(max_coros) * sizeof(eventhub_coro_t*))
+#define EVENTHUB_ARENA_RETAINED_SIZE(max_type_slots) \
+    EVENTHUB_ARENA_ROUND((size_t)(max_type_slots) * sizeof(eventhub_event_t))
+#define EVENTHUB_ARENA_STAMPS_SIZE(max_type_slots) \
+    EVENTHUB_ARENA_ROUND((size_t)(max_type_slots) * sizeof(uint32_t))
+#if EVENTHUB_USING_RTOS
+// 保留有效标志 + 合并待处理标志，以及合并类型的最新值（合并只在RTOS环境有效）
+#define EVENTHUB_ARENA_FLAGS_SIZE(max_type_slots) \
+    EVENTHUB_ARENA_ROUND((size_t)(max_type_slots) * 2 * sizeof(bool))
+#define EVENTHUB_ARENA_COALESCED_SIZE(max_type_slots) \
+    EVENTHUB_ARENA_ROUND((size_t)(max_type_slots) * sizeof(eventhub_event_t))
+#else
+#define EVENTHUB_ARENA_FLAGS_SIZE(max_type_slots) \
+    EVENTHUB_ARENA_ROUND((size_t)(max_type_slots) * sizeof(bool))
+#define EVENTHUB_ARENA_COALESCED_SIZE(max_type_slots) ((size_t)0)
+#endif
+
+// 编译期计算内存区大小（与eventhub_arena_size()结果一致，可用于定义静态数组；
+// 宏本身不检查溢出，超出size_t范围的配置由eventhub_arena_size()返回0拒绝）
+#define EVENTHUB_ARENA_SIZE(max_modules, max_event_types, max_range_subs, max_coros, max_type_slots) \
+    (EVENTHUB_ARENA_BITMAP_SIZE(max_modules, max_event_types) + \
+     EVENTHUB_ARENA_MODULES_SIZE(max_modules) + \
+     EVENTHUB_ARENA_RANGES_SIZE(max_range_subs) + \
+     EVENTHUB_ARENA_COROS_SIZE(max_coros) + \
+     EVENTHUB_ARENA_RETAINED_SIZE(max_type_slots) + \
+     EVENTHUB_ARENA_STAMPS_SIZE(max_type_slots) + \
+     EVENTHUB_ARENA_FLAGS_SIZE(max_type_slots) + \
+     EVENTHUB_ARENA_COALESCED_SIZE(max_type_slots))
+
+// 定义满足对齐要求的静态内存区
+#define EVENTHUB_ARENA_DEFINE(name, size) \
+    static uint64_t name[((size) + sizeof(uint64_t) - 1) / sizeof(uint64_t)]
+
+// 事件中枢句柄（用户无需关心内部结构，各张表位于初始化时提供的内存区中）
 typedef struct 
 {
     // 内部状态（订阅者列表、锁、队列等）
@@ -39,19 +171,94 @@ typedef struct
         eventhub_mutex_t* mutex;
 #if EVENTHUB_USING_RTOS
         eventhub_queue_t* queue;
+        // 保护合并类型状态的锁（只在检查/入队/出队时短暂持有，不跨越回调）
+        eventhub_mutex_t* coalesce_mutex;
+        // 合并类型在队列中是否有待处理事件及其最新值（按策略槽索引）
+        bool* coalesce_queued;
+        eventhub_event_t* coalesced;
 #endif
+        // 容量配置
+        eventhub_config_t config;
+        uint16_t module_words;
+        // 订阅位图（类型优先：每个事件类型一行，分发时只读取连续的一行）
+        uint32_t* sub_bitmap;
         // 模块订阅者列表
-        eventhub_module_subscriber_t module_subscribers[EVENTHUB_MAX_MODULES];
+        eventhub_module_subscriber_t* module_subscribers;
+        // 范围订阅列表（按first升序，分发时遇到first大于事件类型即停止）
+        eventhub_range_subscriber_t* range_subscribers;
+        uint16_t range_count;
+        // 正在进行的范围分发（嵌套时按链表串联，无分发时为NULL）
+        eventhub_range_cursor_t* range_cursor;
+        // 协程订阅者列表（空位为NULL）
+        eventhub_coro_t** coros;
+        uint16_t coro_count;
+        // 事件类型属性表（可选）
+        const eventhub_type_props_t* type_props;
+        uint32_t type_count;
+        // 保留类型的最近一次事件及其序号（按策略槽索引，序号每次保存时递增）
+        eventhub_event_t* retained;
+        uint32_t* retained_stamps;
+        bool* retained_valid;
+        uint32_t retained_stamp;
+        // 使用的默认内存区下标+1（0表示未使用默认内存区，零初始化的句柄不占用任何内存区）
+        uint8_t default_arena;
+        // EVENTHUB_DEFINE绑定的内存区（bound_magic匹配时有效，初始化/销毁后保留）
+        void* bound_arena;
+        uint32_t bound_magic;
     } priv;
 } eventhub_t;
 
+// 按eventhub_config.h中的宏配置所需的内存区大小
+#define EVENTHUB_DEFAULT_ARENA_SIZE \
+    EVENTHUB_ARENA_SIZE(EVENTHUB_MAX_MODULES, EVENTHUB_MAX_EVENT_TYPES, EVENTHUB_MAX_RANGE_SUBS, \
+                        EVENTHUB_MAX_COROS, EVENTHUB_MAX_TYPE_SLOTS)
+
+#define EVENTHUB_BOUND_MAGIC 0x45564842U
+
+// 在文件作用域定义中枢及其专用的默认内存区，eventhub_init直接使用该内存区，
+// 数量不受EVENTHUB_DEFAULT_HUBS限制（其他文件用 extern eventhub_t name; 引用）
+#define EVENTHUB_DEFINE(name) \
+    EVENTHUB_ARENA_DEFINE(name##_arena, EVENTHUB_DEFAULT_ARENA_SIZE); \
+    eventhub_t name = { .priv = { .bound_arena = name##_arena, .bound_magic = EVENTHUB_BOUND_MAGIC } }
+
+/**
+ * 计算指定配置所需的内存区大小
+ * @param config 容量配置
+ * @return 所需字节数，配置无效或大小超出size_t范围时返回0
+ */
+size_t eventhub_arena_size(const eventhub_config_t* config);
+
+/**
+ * 在调用者提供的内存区上初始化事件中枢（容量由运行时配置决定）
+ * @param hub 事件中枢实例
+ * @param config 容量配置
+ * @param arena 内存区首地址（按EVENTHUB_ARENA_ALIGN对齐，建议用EVENTHUB_ARENA_DEFINE定义）
+ * @param arena_size 内存区大小（不小于eventhub_arena_size(config)）
+ * @return 成功返回true
+ */
+bool eventhub_init_static(eventhub_t* hub, const eventhub_config_t* config, void* arena, size_t arena_size);
+
 /**
- * 初始化事件中枢
+ * 初始化事件中枢（按eventhub_config.h中的宏配置，需在多任务启动前调用）
+ * 用EVENTHUB_DEFINE定义的中枢使用自带的内存区，数量不受限制；其他中枢使用库内部的
+ * 默认内存区，可同时存在EVENTHUB_DEFAULT_HUBS个
  * @param hub 事件中枢实例
  * @return 成功返回true
  */
 bool eventhub_init(eventhub_t* hub);
 
+/**
+ * 注册事件类型属性表（可选，通常由生成的 xxx_events_register() 调用）
+ * 注册后发布时按类型常数时间查表：校验负载长度、保留、合并、优先级策略
+ * 需在开始发布事件之前调用（重新注册会清除已保存的保留事件和待合并标记，
+ * 队列中已有的合并事件按入队时的值分发）
+ * @param hub 事件中枢实例
+ * @param props 属性表（以事件类型为下标，须在中枢生命周期内有效）
+ * @param count 属性表项数
+ * @return 成功返回true
+ */
+bool eventhub_set_type_table(eventhub_t* hub, const eventhub_type_props_t* props, uint32_t count);
+
 /**
  * 订阅事件（模块级订阅）
  * @param hub 事件中枢实例
@@ -73,6 +280,79 @@ bool eventhub_subscribe(eventhub_t* hub, eventhub_event_type_t event_type,
 bool eventhub_unsubscribe(eventhub_t* hub, eventhub_event_type_t event_type,
                          eventhub_subscriber_cb cb);
 
+/**
+ * 订阅一段连续的事件类型（范围订阅）
+ * 范围只占用一个表项，与包含的类型数量无关；同一模块可同时使用精确订阅和范围订阅，
+ * 事件同时命中时回调只调用一次
+ * @param hub 事件中枢实例
+ * @param first 起始事件类型（含）
+ * @param last 结束事件类型（含）
+ * @param cb 回调函数
+ * @param user_data 传给回调的用户数据
+ * @return 成功返回true
+ */
+bool eventhub_subscribe_range(eventhub_t* hub, eventhub_event_type_t first, eventhub_event_type_t last,
+                             eventhub_subscriber_cb cb, void* user_data);
+
+/**
+ * 取消范围订阅（first/last需与订阅时一致）
+ * @param hub 事件中枢实例
+ * @param first 起始事件类型（含）
+ * @param last 结束事件类型（含）
+ * @param cb 要取消的回调函数
+ * @return 成功返回true
+ */
+bool eventhub_unsubscribe_range(eventhub_t* hub, eventhub_event_type_t first, eventhub_event_type_t last,
+                               eventhub_subscriber_cb cb);
+
+/**
+ * 订阅整个分组（分组号 = 事件类型 >> EVENTHUB_GROUP_BITS）
+ * @param hub 事件中枢实例
+ * @param group 分组号
+ * @param cb 回调函数
+ * @param user_data 传给回调的用户数据
+ * @return 成功返回true
+ */
+bool eventhub_subscribe_group(eventhub_t* hub, uint32_t group,
+                             eventhub_subscriber_cb cb, void* user_data);
+
+/**
+ * 取消分组订阅
+ * @param hub 事件中枢实例
+ * @param group 分组号
+ * @param cb 要取消的回调函数
+ * @return 成功返回true
+ */
+bool eventhub_unsubscribe_group(eventhub_t* hub, uint32_t group, eventhub_subscriber_cb cb);
+
+/**
+ * 启动协程订阅者：立即执行到第一个 EVENTHUB_AWAIT，之后由中枢在等待的事件到达
+ * 或超时时恢复执行（RTOS在eventhub_process中，裸机在eventhub_publish中）；
+ * 等待保留类型且该类型已有本协程未收到过的保留事件时立即恢复
+ * @param hub 事件中枢实例
+ * @param co 协程状态（须在协程生命周期内有效）
+ * @param fn 协程函数
+ * @param user_data 传给协程的用户数据
+ * @return 成功返回true（协程首次执行即结束时同样返回true）
+ */
+bool eventhub_coro_start(eventhub_t* hub, eventhub_coro_t* co, eventhub_coro_fn fn, void* user_data);
+
+/**
+ * 停止协程订阅者（返回后协程不会再被恢复）
+ * @param hub 事件中枢实例
+ * @param co 协程状态
+ * @return 成功返回true
+ */
+bool eventhub_coro_stop(eventhub_t* hub, eventhub_coro_t* co);
+
+/**
+ * 设置协程等待条件（由 EVENTHUB_AWAIT 宏调用，用户无需直接使用）
+ * @param co 协程状态
+ * @param event_type 等待的事件类型
+ * @param timeout 超时时间（毫秒，EVENTHUB_WAIT_FOREVER=永不超时）
+ */
+void eventhub_coro_await(eventhub_coro_t* co, eventhub_event_type_t event_type, uint32_t timeout);
+
 /**
  * 发布事件
  * @param hub 事件中枢实例
@@ -84,6 +364,8 @@ bool eventhub_publish(eventhub_t* hub, const eventhub_event_t* event, uint32_t t
 
 /**
  * 事件处理（裸机环境需在主循环调用，RTOS环境可作为任务）
+ * 同时检查协程等待超时：RTOS环境下队列等待时间自动缩短到最早的协程截止时间，
+ * timeout可设为永久阻塞
  * @param hub 事件中枢实例
  * @param timeout 等待超时时间（RTOS用ticks，裸机忽略）
  */
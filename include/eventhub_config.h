@@ -10,6 +10,22 @@
 // 事件队列大小（仅RTOS环境有效）
 #define EVENTHUB_QUEUE_SIZE 16
 
+// 保留/合并策略槽数量（事件类型属性表中带retained或coalesced标志的类型总数上限）
+#define EVENTHUB_MAX_TYPE_SLOTS 8
+
+// 范围/分组订阅表容量（每条范围订阅占用一项，与范围包含的类型数量无关）
+#define EVENTHUB_MAX_RANGE_SUBS 16
+
+// 分组位数：事件类型右移该位数得到分组号（8表示每256个类型为一组，如0x100~0x1FF为分组1）
+#define EVENTHUB_GROUP_BITS 8
+
+// 最大协程订阅者数量（每个协程仅占用一个指针，状态由调用者静态分配）
+#define EVENTHUB_MAX_COROS 16
+
+// 未用EVENTHUB_DEFINE定义的中枢调用eventhub_init()时，可同时初始化的数量
+// （库内部按上述宏预留默认内存区；0表示不预留，只使用EVENTHUB_DEFINE或eventhub_init_static()）
+#define EVENTHUB_DEFAULT_HUBS 1
+
 // 是否启用事件日志（调试用）
 #define EVENTHUB_ENABLE_LOG 0
 
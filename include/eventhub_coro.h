@@ -0,0 +1,76 @@
+#ifndef EVENTHUB_CORO_H
+#define EVENTHUB_CORO_H
+
+#include "eventhub.h"
+
+/*
+ * 无栈协程订阅者（Duff's device 实现，类似 protothread）
+ *
+ * 用于替代仅为等待事件序列而存在的独立任务，每个协程只占用一个 eventhub_coro_t：
+ *
+ *     static EVENTHUB_CORO(network_coro)
+ *     {
+ *         EVENTHUB_CORO_BEGIN();
+ *         EVENTHUB_AWAIT(EVENT_VCC_POWER_ON, EVENTHUB_WAIT_FOREVER);
+ *         EVENTHUB_AWAIT(EVENT_LINK_UP, 5000);
+ *         if (EVENTHUB_CORO_TIMED_OUT()) 
+ *         {
+ *             // 5秒内未连接
+ *         }
+ *         EVENTHUB_CORO_END();
+ *     }
+ *
+ *     static eventhub_coro_t g_network_coro;
+ *     eventhub_coro_start(&g_hub, &g_network_coro, network_coro, NULL);
+ *
+ * 注意事项：
+ *   1. 局部变量在 EVENTHUB_AWAIT 前后不保留，需保留的状态放在静态变量或 user_data 中。
+ *   2. 协程体内不能使用 switch 语句包裹 EVENTHUB_AWAIT，每行最多一个 EVENTHUB_AWAIT。
+ *   3. 协程在持有中枢互斥锁时执行，与普通回调一样需简短无阻塞。
+ *   4. 等待保留类型时，若已有本协程未收到过的保留事件，立即以该事件恢复（与订阅时补发一致）。
+ */
+
+// 定义协程函数（参数名固定为 co / event / user_data，供下列宏使用）
+#define EVENTHUB_CORO(name) \
+    eventhub_coro_status_t name(eventhub_coro_t* co, const eventhub_event_t* event, void* user_data)
+
+// 协程体开始
+#define EVENTHUB_CORO_BEGIN() \
+    (void)event; \
+    (void)user_data; \
+    switch (co->lc) \
+    { \
+    case 0:
+
+// 挂起直到收到 type 类型事件或超时（timeout 毫秒，EVENTHUB_WAIT_FOREVER=永不超时），
+// type 为保留类型且已有未收到过的保留事件时立即恢复
+#define EVENTHUB_AWAIT(type, timeout) \
+    do \
+    { \
+        eventhub_coro_await(co, (type), (timeout)); \
+        co->lc = (uint16_t)__LINE__; \
+        return EVENTHUB_CORO_WAITING; \
+    case __LINE__:; \
+    } while (0)
+
+// 最近一次 EVENTHUB_AWAIT 是否因超时返回（超时时 EVENTHUB_CORO_EVENT() 为NULL）
+#define EVENTHUB_CORO_TIMED_OUT() (co->timed_out != 0)
+
+// 唤醒协程的事件（仅在本次恢复执行期间有效）
+#define EVENTHUB_CORO_EVENT() (event)
+
+// 提前结束协程
+#define EVENTHUB_CORO_EXIT() \
+    do \
+    { \
+        co->lc = 0; \
+        return EVENTHUB_CORO_DONE; \
+    } while (0)
+
+// 协程体结束
+#define EVENTHUB_CORO_END() \
+    } \
+    co->lc = 0; \
+    return EVENTHUB_CORO_DONE
+
+#endif
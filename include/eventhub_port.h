@@ -5,6 +5,9 @@
 #include <stdbool.h>
 #include "eventhub_config.h"
 
+// 永久等待的超时值（FreeRTOS 32位tick时与portMAX_DELAY相同）
+#define EVENTHUB_PORT_MAX_DELAY 0xFFFFFFFFU
+
 // 时间戳类型（毫秒级）
 typedef uint32_t eventhub_timestamp_t;
 
@@ -53,6 +56,13 @@ void eventhub_port_mutex_destroy(eventhub_mutex_t* mutex);
 eventhub_timestamp_t eventhub_port_get_timestamp(void);
 
 #if EVENTHUB_USING_RTOS
+/**
+ * 毫秒转换为队列/互斥锁的超时单位（RTOS环境，向上取整，用于按协程截止时间限制等待）
+ * @param ms 毫秒数
+ * @return 对应的超时值
+ */
+uint32_t eventhub_port_ms_to_ticks(uint32_t ms);
+
 /**
  * 初始化事件队列（RTOS环境）
  * @param item_size 队列项大小
@@ -70,6 +80,15 @@ eventhub_queue_t* eventhub_port_queue_init(uint32_t item_size, uint32_t queue_le
  */
 bool eventhub_port_queue_send(eventhub_queue_t* queue, const void* data, uint32_t timeout);
 
+/**
+ * 向队列头部发送数据（RTOS环境，用于优先级事件）
+ * @param queue 队列对象
+ * @param data 要发送的数据指针
+ * @param timeout 超时时间
+ * @return 成功返回true
+ */
+bool eventhub_port_queue_send_front(eventhub_queue_t* queue, const void* data, uint32_t timeout);
+
 /**
  * 从队列接收数据（RTOS环境）
  * @param queue 队列对象
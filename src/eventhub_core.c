@@ -7,57 +7,379 @@
 #define EVENTHUB_LOG(...)
 #endif
 
-// 辅助函数：设置事件位
-static inline void set_event_bit(uint32_t* mask, eventhub_event_type_t event_type) 
+#if EVENTHUB_USING_RTOS
+// 唤醒处理任务重新计算等待时间的内部事件类型（不在任何中枢的事件类型空间内，不分发）
+#define EVENTHUB_WAKEUP_EVENT 0xFFFFFFFFU
+#endif
+
+// 默认内存区（未用EVENTHUB_DEFINE定义的中枢调用eventhub_init时使用）
+#if EVENTHUB_DEFAULT_HUBS > 0
+EVENTHUB_ARENA_DEFINE(default_arenas, EVENTHUB_DEFAULT_ARENA_SIZE * EVENTHUB_DEFAULT_HUBS);
+static bool default_arena_used[EVENTHUB_DEFAULT_HUBS];
+#endif
+
+// 辅助函数：计算最低位1的位置（mask不能为0）
+static inline uint32_t lowest_bit(uint32_t mask) 
 {
-    if (event_type < EVENTHUB_MAX_EVENT_TYPES) 
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_ctz(mask);
+#else
+    uint32_t bit = 0;
+    while ((mask & 1U) == 0) 
     {
-        uint32_t word_index = event_type / EVENT_MASK_BITS_PER_WORD;
-        uint32_t bit_index = event_type % EVENT_MASK_BITS_PER_WORD;
-        mask[word_index] |= (1U << bit_index);
+        mask >>= 1;
+        bit++;
     }
+    return bit;
+#endif
+}
+
+// 辅助函数：获取事件类型在订阅位图中的行
+static inline uint32_t* get_type_row(const eventhub_t* hub, eventhub_event_type_t event_type) 
+{
+    return &hub->priv.sub_bitmap[(size_t)event_type * hub->priv.module_words];
+}
+
+// 辅助函数：设置事件位，返回该位原来是否已设置
+static inline bool set_event_bit(eventhub_t* hub, uint16_t module, eventhub_event_type_t event_type) 
+{
+    uint32_t* row = get_type_row(hub, event_type);
+    uint32_t word_index = module / EVENT_MASK_BITS_PER_WORD;
+    uint32_t bit = 1U << (module % EVENT_MASK_BITS_PER_WORD);
+    bool was_set = (row[word_index] & bit) != 0;
+    row[word_index] |= bit;
+    return was_set;
 }
 
-// 辅助函数：清除事件位
-static inline void clear_event_bit(uint32_t* mask, eventhub_event_type_t event_type) 
+// 辅助函数：清除事件位，返回该位原来是否已设置
+static inline bool clear_event_bit(eventhub_t* hub, uint16_t module, eventhub_event_type_t event_type) 
 {
-    if (event_type < EVENTHUB_MAX_EVENT_TYPES) 
+    uint32_t* row = get_type_row(hub, event_type);
+    uint32_t word_index = module / EVENT_MASK_BITS_PER_WORD;
+    uint32_t bit = 1U << (module % EVENT_MASK_BITS_PER_WORD);
+    bool was_set = (row[word_index] & bit) != 0;
+    row[word_index] &= ~bit;
+    return was_set;
+}
+
+// 辅助函数：检查事件位是否设置
+static inline bool is_event_set(const eventhub_t* hub, uint16_t module, eventhub_event_type_t event_type) 
+{
+    const uint32_t* row = get_type_row(hub, event_type);
+    return (row[module / EVENT_MASK_BITS_PER_WORD] & (1U << (module % EVENT_MASK_BITS_PER_WORD))) != 0;
+}
+
+// 辅助函数：释放不再订阅任何事件的模块
+static inline void release_module_ref(eventhub_t* hub, uint16_t module) 
+{
+    if (--hub->priv.module_subscribers[module].ref_count == 0) 
     {
-        uint32_t word_index = event_type / EVENT_MASK_BITS_PER_WORD;
-        uint32_t bit_index = event_type % EVENT_MASK_BITS_PER_WORD;
-        mask[word_index] &= ~(1U << bit_index);
+        hub->priv.module_subscribers[module].in_use = false;
     }
 }
 
-// 辅助函数：检查事件位是否设置
-static inline bool is_event_set(const uint32_t* mask, eventhub_event_type_t event_type) 
+// 辅助函数：校验容量配置
+static bool is_config_valid(const eventhub_config_t* config) 
 {
-    if (event_type < EVENTHUB_MAX_EVENT_TYPES) 
+    if (config == NULL || 
+        config->max_modules == 0 || 
+        config->max_event_types == 0 || 
+        config->max_type_slots >= EVENTHUB_TYPE_NO_SLOT) 
     {
-        uint32_t word_index = event_type / EVENT_MASK_BITS_PER_WORD;
-        uint32_t bit_index = event_type % EVENT_MASK_BITS_PER_WORD;
-        return (mask[word_index] & (1U << bit_index)) != 0;
+        return false;
     }
-    return false;
+
+    // 订阅位图大小（类型数 * 每行字节数）不能超过size_t的一半，其余各表均由16位计数决定，
+    // 远小于另一半，内存区总大小不会溢出
+    size_t row_bytes = (size_t)EVENTHUB_MODULE_WORDS(config->max_modules) * sizeof(uint32_t);
+    return (size_t)config->max_event_types <= (SIZE_MAX / 2) / row_bytes;
 }
 
-// 辅助函数：检查位图是否为空
-static inline bool is_mask_empty(const uint32_t* mask) 
+// 辅助函数：查找事件类型属性（未注册属性表或类型未定义时返回NULL）
+static inline const eventhub_type_props_t* get_type_props(const eventhub_t* hub, eventhub_event_type_t event_type) 
 {
-    for (int i = 0; i < EVENT_MASK_WORDS; i++) 
+    if (hub->priv.type_props != NULL && event_type < hub->priv.type_count) 
     {
-        if (mask[i] != 0) 
+        const eventhub_type_props_t* props = &hub->priv.type_props[event_type];
+        if (props->flags & EVENTHUB_TYPE_FLAG_DEFINED) 
         {
-            return false;
+            return props;
         }
     }
+    return NULL;
+}
+
+// 辅助函数：获取类型的策略槽下标（无效时返回EVENTHUB_TYPE_NO_SLOT）
+static inline uint8_t get_type_slot(const eventhub_t* hub, const eventhub_type_props_t* props, uint8_t flag) 
+{
+    if (props != NULL && (props->flags & flag) && props->slot < hub->priv.config.max_type_slots) 
+    {
+        return props->slot;
+    }
+    return EVENTHUB_TYPE_NO_SLOT;
+}
+
+// 辅助函数：计算分组的结束类型（最后一个分组截断到中枢的事件类型空间）
+static inline bool get_group_last(const eventhub_t* hub, uint32_t group, eventhub_event_type_t* last) 
+{
+    uint32_t max_event_types = hub->priv.config.max_event_types;
+    if (group > ((max_event_types - 1) >> EVENTHUB_GROUP_BITS)) return false;
+
+    *last = EVENTHUB_GROUP_LAST(group);
+    if (*last >= max_event_types) 
+    {
+        *last = max_event_types - 1;
+    }
     return true;
 }
 
-bool eventhub_init(eventhub_t* hub) 
+// 辅助函数：执行协程直到挂起或结束，结束后从中枢移除；挂起在已有未收到过的保留事件的类型上时
+// 立即以保留事件恢复，与订阅时补发保留事件一致（调用前需持有互斥锁）
+static void run_coro(eventhub_t* hub, uint16_t index, const eventhub_event_t* event, bool timed_out) 
 {
-    if (hub == NULL) return false;
+    eventhub_coro_t* co = hub->priv.coros[index];
+    while (true) 
+    {
+        co->timed_out = timed_out;
+        co->has_deadline = 0;
+        if (co->fn(co, event, co->user_data) == EVENTHUB_CORO_DONE) 
+        {
+            hub->priv.coros[index] = NULL;
+            hub->priv.coro_count--;
+            return;
+        }
+
+        uint8_t slot = get_type_slot(hub, get_type_props(hub, co->wait_type), EVENTHUB_TYPE_FLAG_RETAINED);
+        if (slot == EVENTHUB_TYPE_NO_SLOT || !hub->priv.retained_valid[slot] ||
+            hub->priv.retained_stamps[slot] == co->retained_stamp) 
+        {
+            return;
+        }
+        co->retained_stamp = hub->priv.retained_stamps[slot];
+        event = &hub->priv.retained[slot];
+        timed_out = false;
+    }
+}
+
+// 辅助函数：恢复已到期的协程（调用前需持有互斥锁）
+static void check_coro_timeouts(eventhub_t* hub) 
+{
+    eventhub_timestamp_t now = eventhub_port_get_timestamp();
+    for (uint16_t i = 0; i < hub->priv.config.max_coros && hub->priv.coro_count > 0; i++) 
+    {
+        eventhub_coro_t* co = hub->priv.coros[i];
+        // 差值按有符号比较，兼容时间戳回绕
+        if (co != NULL && co->has_deadline && (int32_t)(now - co->deadline) >= 0) 
+        {
+            run_coro(hub, i, NULL, true);
+        }
+    }
+}
+
+#if EVENTHUB_USING_RTOS
+// 辅助函数：按最早的协程截止时间缩短队列等待时间，保证超时的协程按时恢复（调用前需持有互斥锁）
+static uint32_t limit_wait_timeout(const eventhub_t* hub, uint32_t timeout) 
+{
+    eventhub_timestamp_t now = eventhub_port_get_timestamp();
+    for (uint16_t i = 0; i < hub->priv.config.max_coros && hub->priv.coro_count > 0; i++) 
+    {
+        const eventhub_coro_t* co = hub->priv.coros[i];
+        if (co == NULL || !co->has_deadline) continue;
+
+        int32_t remaining = (int32_t)(co->deadline - now);
+        uint32_t ticks = (remaining > 0) ? eventhub_port_ms_to_ticks((uint32_t)remaining) : 0;
+        if (ticks < timeout) 
+        {
+            timeout = ticks;
+        }
+    }
+    return timeout;
+}
+#endif
+
+// 辅助函数：分发事件给所有订阅者（调用前需持有互斥锁）
+static void dispatch_event(eventhub_t* hub, const eventhub_event_t* event) 
+{
+    // 保留类型：记录最近一次事件，供之后的订阅者补发
+    uint8_t slot = get_type_slot(hub, get_type_props(hub, event->type), EVENTHUB_TYPE_FLAG_RETAINED);
+    if (slot != EVENTHUB_TYPE_NO_SLOT) 
+    {
+        // 序号0表示未收到过保留事件
+        if (++hub->priv.retained_stamp == 0) 
+        {
+            hub->priv.retained_stamp = 1;
+        }
+        hub->priv.retained[slot] = *event;
+        hub->priv.retained_stamps[slot] = hub->priv.retained_stamp;
+        hub->priv.retained_valid[slot] = true;
+    }
+
+    if (event->type >= hub->priv.config.max_event_types) return;
+
+    // 精确订阅：只读取该类型的一行位图，逐个取出已置位的模块
+    uint32_t* row = get_type_row(hub, event->type);
+    for (uint16_t w = 0; w < hub->priv.module_words; w++) 
+    {
+        uint32_t bits = row[w];
+        while (bits != 0) 
+        {
+            uint32_t bit = lowest_bit(bits);
+            bits &= bits - 1;
+            // 回调中可能已取消订阅，调用前重新检查
+            if ((row[w] & (1U << bit)) == 0) continue;
+
+            eventhub_module_subscriber_t* module = &hub->priv.module_subscribers[w * EVENT_MASK_BITS_PER_WORD + bit];
+            if (module->in_use && module->cb != NULL) 
+            {
+                module->cb(event, module->user_data);
+            }
+        }
+    }
+
+    // 范围订阅：有序区间表，first大于事件类型后不可能再命中
+    // 回调中可能增删范围订阅使表项移动，游标由增删处修正，保证不跳过也不重复
+    eventhub_range_cursor_t cursor = { 0, hub->priv.range_cursor };
+    hub->priv.range_cursor = &cursor;
+    while (cursor.next < hub->priv.range_count && hub->priv.range_subscribers[cursor.next].first <= event->type) 
+    {
+        const eventhub_range_subscriber_t* range = &hub->priv.range_subscribers[cursor.next++];
+        if (event->type > range->last) continue;
+
+        // 同一模块已通过之前的范围（covered_end）或精确订阅收到该事件时不再重复调用
+        if (event->type < range->covered_end || is_event_set(hub, range->module, event->type)) continue;
+
+        eventhub_module_subscriber_t* module = &hub->priv.module_subscribers[range->module];
+        if (module->in_use && module->cb != NULL) 
+        {
+            module->cb(event, module->user_data);
+        }
+    }
+    hub->priv.range_cursor = cursor.outer;
+
+    // 恢复等待该事件的协程
+    for (uint16_t i = 0; i < hub->priv.config.max_coros && hub->priv.coro_count > 0; i++) 
+    {
+        if (hub->priv.coros[i] != NULL && hub->priv.coros[i]->wait_type == event->type) 
+        {
+            // 已通过分发收到这次保留事件，之后等待同一类型时不再用它恢复
+            if (slot != EVENTHUB_TYPE_NO_SLOT) 
+            {
+                hub->priv.coros[i]->retained_stamp = hub->priv.retained_stamps[slot];
+            }
+            run_coro(hub, i, event, false);
+        }
+    }
+}
+
+// 辅助函数：范围表在index处插入（delta=1）或删除（delta=-1）表项后，修正进行中的分发游标
+// （插在游标处的新订阅与精确订阅一致，不接收正在分发的事件）
+static void adjust_range_cursors(eventhub_t* hub, uint16_t index, int delta) 
+{
+    for (eventhub_range_cursor_t* cursor = hub->priv.range_cursor; cursor != NULL; cursor = cursor->outer) 
+    {
+        if (index < cursor->next || (delta > 0 && index == cursor->next)) 
+        {
+            cursor->next = (uint16_t)(cursor->next + delta);
+        }
+    }
+}
+
+// 辅助函数：范围表变化后重新计算模块各范围的covered_end（调用前需持有互斥锁）
+// 表按first升序，排在前面的范围first不大于当前范围，事件类型落在当前范围内时，
+// 只要不超过前面某个范围的last就已由该范围分发过
+static void update_range_coverage(eventhub_t* hub, uint16_t module) 
+{
+    eventhub_event_type_t covered_end = 0;
+    for (uint16_t r = 0; r < hub->priv.range_count; r++) 
+    {
+        eventhub_range_subscriber_t* range = &hub->priv.range_subscribers[r];
+        if (range->module != module) continue;
+
+        range->covered_end = covered_end;
+        if (range->last + 1 > covered_end) 
+        {
+            covered_end = range->last + 1;
+        }
+    }
+}
+
+// 辅助函数：检查模块是否已通过精确订阅或范围订阅接收该事件类型（调用前需持有互斥锁）
+static bool is_type_received(const eventhub_t* hub, uint16_t module, eventhub_event_type_t event_type) 
+{
+    if (is_event_set(hub, module, event_type)) return true;
+
+    for (uint16_t r = 0; r < hub->priv.range_count && hub->priv.range_subscribers[r].first <= event_type; r++) 
+    {
+        if (hub->priv.range_subscribers[r].module == module && event_type <= hub->priv.range_subscribers[r].last) 
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 辅助函数：向模块补发[first, last]范围内的保留事件（在登记新订阅之前调用，
+// 模块已订阅的类型此前已收到过，不再重复补发；调用前需持有互斥锁）
+static void deliver_retained(eventhub_t* hub, uint16_t module, eventhub_event_type_t first, eventhub_event_type_t last) 
+{
+    eventhub_module_subscriber_t* subscriber = &hub->priv.module_subscribers[module];
+    for (uint8_t slot = 0; slot < hub->priv.config.max_type_slots; slot++) 
+    {
+        const eventhub_event_t* event = &hub->priv.retained[slot];
+        if (hub->priv.retained_valid[slot] && event->type >= first && event->type <= last &&
+            !is_type_received(hub, module, event->type)) 
+        {
+            subscriber->cb(event, subscriber->user_data);
+        }
+    }
+}
+
+size_t eventhub_arena_size(const eventhub_config_t* config) 
+{
+    if (!is_config_valid(config)) return 0;
+
+    return EVENTHUB_ARENA_SIZE(config->max_modules, config->max_event_types, config->max_range_subs,
+                               config->max_coros, config->max_type_slots);
+}
+
+bool eventhub_init_static(eventhub_t* hub, const eventhub_config_t* config, void* arena, size_t arena_size) 
+{
+    if (hub == NULL || arena == NULL) return false;
+
+    size_t required = eventhub_arena_size(config);
+    if (required == 0 || arena_size < required || ((uintptr_t)arena % EVENTHUB_ARENA_ALIGN) != 0) 
+    {
+        EVENTHUB_LOG("eventhub: invalid config or arena (need %d bytes)\n", (int)required);
+        return false;
+    }
+
     memset(hub, 0, sizeof(eventhub_t));
+    memset(arena, 0, required);
+    hub->priv.config = *config;
+    hub->priv.module_words = EVENTHUB_MODULE_WORDS(config->max_modules);
+
+    // 按分发时的访问频率依次划分各张表：订阅位图 -> 模块 -> 范围 -> 协程 -> 保留事件 -> 序号 -> 标志 -> 合并事件
+    uint8_t* p = (uint8_t*)arena;
+    hub->priv.sub_bitmap = (uint32_t*)p;
+    p += EVENTHUB_ARENA_BITMAP_SIZE(config->max_modules, config->max_event_types);
+    hub->priv.module_subscribers = (eventhub_module_subscriber_t*)p;
+    p += EVENTHUB_ARENA_MODULES_SIZE(config->max_modules);
+    hub->priv.range_subscribers = (eventhub_range_subscriber_t*)p;
+    p += EVENTHUB_ARENA_RANGES_SIZE(config->max_range_subs);
+    hub->priv.coros = (eventhub_coro_t**)p;
+    p += EVENTHUB_ARENA_COROS_SIZE(config->max_coros);
+    hub->priv.retained = (eventhub_event_t*)p;
+    p += EVENTHUB_ARENA_RETAINED_SIZE(config->max_type_slots);
+    hub->priv.retained_stamps = (uint32_t*)p;
+    p += EVENTHUB_ARENA_STAMPS_SIZE(config->max_type_slots);
+    hub->priv.retained_valid = (bool*)p;
+#if EVENTHUB_USING_RTOS
+    hub->priv.coalesce_queued = hub->priv.retained_valid + config->max_type_slots;
+#endif
+    p += EVENTHUB_ARENA_FLAGS_SIZE(config->max_type_slots);
+#if EVENTHUB_USING_RTOS
+    hub->priv.coalesced = (eventhub_event_t*)p;
+#endif
 
     // 初始化互斥锁
     hub->priv.mutex = eventhub_port_mutex_init();
@@ -69,23 +391,142 @@ bool eventhub_init(eventhub_t* hub)
 
 #if EVENTHUB_USING_RTOS
     // 初始化事件队列（存储eventhub_event_t类型）
-    hub->priv.queue = eventhub_port_queue_init(sizeof(eventhub_event_t), EVENTHUB_QUEUE_SIZE);
+    hub->priv.queue = eventhub_port_queue_init(sizeof(eventhub_event_t), config->queue_size);
     if (NULL == hub->priv.queue) 
     {
         EVENTHUB_LOG("eventhub: queue init failed\n");
         eventhub_port_mutex_destroy(hub->priv.mutex);
         return false;
     }
+
+    hub->priv.coalesce_mutex = eventhub_port_mutex_init();
+    if (NULL == hub->priv.coalesce_mutex) 
+    {
+        EVENTHUB_LOG("eventhub: mutex init failed\n");
+        eventhub_port_queue_destroy(hub->priv.queue);
+        eventhub_port_mutex_destroy(hub->priv.mutex);
+        return false;
+    }
+#endif
+
+    EVENTHUB_LOG("eventhub: init success (RTOS=%d, arena=%d bytes)\n", EVENTHUB_USING_RTOS, (int)required);
+    return true;
+}
+
+// 辅助函数：是否为EVENTHUB_DEFINE定义的中枢
+static inline bool has_bound_arena(const eventhub_t* hub) 
+{
+    return hub->priv.bound_magic == EVENTHUB_BOUND_MAGIC && hub->priv.bound_arena != NULL;
+}
+
+#if EVENTHUB_DEFAULT_HUBS > 0
+// 辅助函数：中枢当前占用的默认内存区下标（未占用返回-1；同时核对表指针，避免未初始化的句柄误判）
+static int get_default_arena(const eventhub_t* hub) 
+{
+    int i = (int)hub->priv.default_arena - 1;
+    if (i < 0 || i >= EVENTHUB_DEFAULT_HUBS || !default_arena_used[i]) return -1;
+
+    uint8_t* arena = (uint8_t*)default_arenas + (size_t)i * EVENTHUB_DEFAULT_ARENA_SIZE;
+    return ((uint8_t*)hub->priv.sub_bitmap == arena) ? i : -1;
+}
+#endif
+
+bool eventhub_init(eventhub_t* hub) 
+{
+    if (hub == NULL) return false;
+
+    static const eventhub_config_t default_config = EVENTHUB_CONFIG_DEFAULT;
+
+    // EVENTHUB_DEFINE定义的中枢：使用自带的内存区（初始化会清零句柄，之后恢复绑定）
+    if (has_bound_arena(hub)) 
+    {
+        void* arena = hub->priv.bound_arena;
+        bool ret = eventhub_init_static(hub, &default_config, arena, EVENTHUB_DEFAULT_ARENA_SIZE);
+        hub->priv.bound_arena = arena;
+        hub->priv.bound_magic = EVENTHUB_BOUND_MAGIC;
+        return ret;
+    }
+
+#if EVENTHUB_DEFAULT_HUBS > 0
+    // 再次初始化时沿用已占用的内存区，否则按宏配置占用一块空闲的默认内存区
+    int owned = get_default_arena(hub);
+    for (int i = 0; i < EVENTHUB_DEFAULT_HUBS; i++) 
+    {
+        if ((owned < 0 && !default_arena_used[i]) || owned == i) 
+        {
+            uint8_t* arena = (uint8_t*)default_arenas + (size_t)i * EVENTHUB_DEFAULT_ARENA_SIZE;
+            if (!eventhub_init_static(hub, &default_config, arena, EVENTHUB_DEFAULT_ARENA_SIZE)) 
+            {
+                default_arena_used[i] = false;
+                return false;
+            }
+            default_arena_used[i] = true;
+            hub->priv.default_arena = (uint8_t)(i + 1);
+            return true;
+        }
+    }
+#endif
+
+    EVENTHUB_LOG("eventhub: init failed (no default arena, use EVENTHUB_DEFINE)\n");
+    return false;
+}
+
+bool eventhub_set_type_table(eventhub_t* hub, const eventhub_type_props_t* props, uint32_t count) 
+{
+    if (hub == NULL || (props == NULL && count != 0)) return false;
+
+    // 超出事件类型空间的表项无法订阅
+    if (count > hub->priv.config.max_event_types) 
+    {
+        EVENTHUB_LOG("eventhub: type table larger than event type space\n");
+        return false;
+    }
+
+    // 策略槽必须在配置范围内，否则保留/合并策略无法生效
+    for (uint32_t i = 0; i < count; i++) 
+    {
+        if ((props[i].flags & (EVENTHUB_TYPE_FLAG_RETAINED | EVENTHUB_TYPE_FLAG_COALESCED)) &&
+            props[i].slot >= hub->priv.config.max_type_slots) 
+        {
+            EVENTHUB_LOG("eventhub: type %d slot out of range\n", i);
+            return false;
+        }
+    }
+
+    if (!eventhub_port_mutex_lock(hub->priv.mutex, 0))
+    {
+        EVENTHUB_LOG("eventhub: mutex lock failed\n");
+        return false;
+    }
+
+#if EVENTHUB_USING_RTOS
+    // 策略槽随属性表重新分配：待合并标记与发布时的检查/入队在同一把锁内清除
+    // （发布者可能持锁等待队列空位，需等待；队列中已有的合并事件按入队时的值分发）
+    if (!eventhub_port_mutex_lock(hub->priv.coalesce_mutex, EVENTHUB_PORT_MAX_DELAY))
+    {
+        eventhub_port_mutex_unlock(hub->priv.mutex);
+        EVENTHUB_LOG("eventhub: mutex lock failed\n");
+        return false;
+    }
 #endif
 
-    EVENTHUB_LOG("eventhub: init success (RTOS=%d)\n", EVENTHUB_USING_RTOS);
+    hub->priv.type_props = props;
+    hub->priv.type_count = count;
+    memset(hub->priv.retained_valid, 0, hub->priv.config.max_type_slots * sizeof(bool));
+
+#if EVENTHUB_USING_RTOS
+    memset(hub->priv.coalesce_queued, 0, hub->priv.config.max_type_slots * sizeof(bool));
+    eventhub_port_mutex_unlock(hub->priv.coalesce_mutex);
+#endif
+    eventhub_port_mutex_unlock(hub->priv.mutex);
+    EVENTHUB_LOG("eventhub: type table registered (%d types)\n", count);
     return true;
 }
 
 bool eventhub_subscribe(eventhub_t* hub, eventhub_event_type_t event_type,
                        eventhub_subscriber_cb cb, void* user_data) 
 {
-    if (hub == NULL || cb == NULL || event_type >= EVENTHUB_MAX_EVENT_TYPES) 
+    if (hub == NULL || cb == NULL || event_type >= hub->priv.config.max_event_types) 
         return false;
 
     if (!eventhub_port_mutex_lock(hub->priv.mutex, 0))
@@ -95,14 +536,19 @@ bool eventhub_subscribe(eventhub_t* hub, eventhub_event_type_t event_type,
     }
 
     // 查找是否已存在该模块（相同回调和用户数据）
-    for (uint16_t i = 0; i < EVENTHUB_MAX_MODULES; i++) 
+    for (uint16_t i = 0; i < hub->priv.config.max_modules; i++) 
     {
         if (hub->priv.module_subscribers[i].in_use &&
             hub->priv.module_subscribers[i].cb == cb &&
             hub->priv.module_subscribers[i].user_data == user_data) 
         {
             // 同一模块添加新事件类型
-            set_event_bit(hub->priv.module_subscribers[i].event_mask, event_type);
+            if (!is_event_set(hub, i, event_type)) 
+            {
+                deliver_retained(hub, i, event_type, event_type);
+                set_event_bit(hub, i, event_type);
+                hub->priv.module_subscribers[i].ref_count++;
+            }
             eventhub_port_mutex_unlock(hub->priv.mutex);
             EVENTHUB_LOG("eventhub: module subscribe event %d\n", event_type);
             return true;
@@ -110,15 +556,15 @@ bool eventhub_subscribe(eventhub_t* hub, eventhub_event_type_t event_type,
     }
 
     // 查找空位置注册新模块
-    for (uint16_t i = 0; i < EVENTHUB_MAX_MODULES; i++) 
+    for (uint16_t i = 0; i < hub->priv.config.max_modules; i++) 
     {
         if (!hub->priv.module_subscribers[i].in_use) 
         {
             hub->priv.module_subscribers[i].cb = cb;
             hub->priv.module_subscribers[i].user_data = user_data;
-            memset(hub->priv.module_subscribers[i].event_mask, 0, 
-                   sizeof(hub->priv.module_subscribers[i].event_mask));
-            set_event_bit(hub->priv.module_subscribers[i].event_mask, event_type);
+            hub->priv.module_subscribers[i].ref_count = 1;
+            deliver_retained(hub, i, event_type, event_type);
+            set_event_bit(hub, i, event_type);
             hub->priv.module_subscribers[i].in_use = true;
             eventhub_port_mutex_unlock(hub->priv.mutex);
             EVENTHUB_LOG("eventhub: new module subscribe event %d\n", event_type);
@@ -134,7 +580,7 @@ bool eventhub_subscribe(eventhub_t* hub, eventhub_event_type_t event_type,
 bool eventhub_unsubscribe(eventhub_t* hub, eventhub_event_type_t event_type,
                          eventhub_subscriber_cb cb) 
 {
-    if (hub == NULL || cb == NULL || event_type >= EVENTHUB_MAX_EVENT_TYPES) 
+    if (hub == NULL || cb == NULL || event_type >= hub->priv.config.max_event_types) 
         return false;
 
     if (!eventhub_port_mutex_lock(hub->priv.mutex, 0))
@@ -144,18 +590,15 @@ bool eventhub_unsubscribe(eventhub_t* hub, eventhub_event_type_t event_type,
     }
 
     // 查找对应的模块订阅者
-    for (uint16_t i = 0; i < EVENTHUB_MAX_MODULES; i++) 
+    for (uint16_t i = 0; i < hub->priv.config.max_modules; i++) 
     {
         if (hub->priv.module_subscribers[i].in_use &&
             hub->priv.module_subscribers[i].cb == cb) 
         {
-            // 清除该事件类型的位
-            clear_event_bit(hub->priv.module_subscribers[i].event_mask, event_type);
-            
-            // 如果该模块不再订阅任何事件，则完全取消订阅
-            if (is_mask_empty(hub->priv.module_subscribers[i].event_mask)) 
+            // 清除该事件类型的位，如果该模块不再订阅任何事件，则完全取消订阅
+            if (clear_event_bit(hub, i, event_type)) 
             {
-                hub->priv.module_subscribers[i].in_use = false;
+                release_module_ref(hub, i);
             }
             
             eventhub_port_mutex_unlock(hub->priv.mutex);
@@ -169,17 +612,304 @@ bool eventhub_unsubscribe(eventhub_t* hub, eventhub_event_type_t event_type,
     return false;
 }
 
+bool eventhub_subscribe_range(eventhub_t* hub, eventhub_event_type_t first, eventhub_event_type_t last,
+                             eventhub_subscriber_cb cb, void* user_data) 
+{
+    if (hub == NULL || cb == NULL || first > last || last >= hub->priv.config.max_event_types) 
+        return false;
+
+    if (!eventhub_port_mutex_lock(hub->priv.mutex, 0))
+    {
+        EVENTHUB_LOG("eventhub: mutex lock failed\n");
+        return false;
+    }
+
+    // 查找已存在的模块，不存在则占用空位置
+    uint16_t max_modules = hub->priv.config.max_modules;
+    uint16_t module = max_modules;
+    uint16_t free_slot = max_modules;
+    for (uint16_t i = 0; i < hub->priv.config.max_modules; i++) 
+    {
+        if (hub->priv.module_subscribers[i].in_use &&
+            hub->priv.module_subscribers[i].cb == cb &&
+            hub->priv.module_subscribers[i].user_data == user_data) 
+        {
+            module = i;
+            break;
+        }
+        if (!hub->priv.module_subscribers[i].in_use && free_slot == max_modules) 
+        {
+            free_slot = i;
+        }
+    }
+
+    if (module != max_modules) 
+    {
+        // 重复订阅同一范围视为成功
+        for (uint16_t r = 0; r < hub->priv.range_count; r++) 
+        {
+            if (hub->priv.range_subscribers[r].module == module &&
+                hub->priv.range_subscribers[r].first == first &&
+                hub->priv.range_subscribers[r].last == last) 
+            {
+                eventhub_port_mutex_unlock(hub->priv.mutex);
+                return true;
+            }
+        }
+    }
+    else if (free_slot == max_modules) 
+    {
+        eventhub_port_mutex_unlock(hub->priv.mutex);
+        EVENTHUB_LOG("eventhub: subscribe range failed (max modules)\n");
+        return false;
+    }
+
+    if (hub->priv.range_count >= hub->priv.config.max_range_subs) 
+    {
+        eventhub_port_mutex_unlock(hub->priv.mutex);
+        EVENTHUB_LOG("eventhub: subscribe range failed (max ranges)\n");
+        return false;
+    }
+
+    if (module == max_modules) 
+    {
+        module = free_slot;
+        hub->priv.module_subscribers[module].cb = cb;
+        hub->priv.module_subscribers[module].user_data = user_data;
+        hub->priv.module_subscribers[module].ref_count = 0;
+        hub->priv.module_subscribers[module].in_use = true;
+    }
+    hub->priv.module_subscribers[module].ref_count++;
+    deliver_retained(hub, module, first, last);
+
+    // 按first升序插入
+    uint16_t pos = hub->priv.range_count;
+    while (pos > 0 && hub->priv.range_subscribers[pos - 1].first > first) 
+    {
+        hub->priv.range_subscribers[pos] = hub->priv.range_subscribers[pos - 1];
+        pos--;
+    }
+    hub->priv.range_subscribers[pos].first = first;
+    hub->priv.range_subscribers[pos].last = last;
+    hub->priv.range_subscribers[pos].module = module;
+    hub->priv.range_count++;
+    adjust_range_cursors(hub, pos, 1);
+    update_range_coverage(hub, module);
+
+    eventhub_port_mutex_unlock(hub->priv.mutex);
+    EVENTHUB_LOG("eventhub: subscribe range %d-%d\n", first, last);
+    return true;
+}
+
+bool eventhub_unsubscribe_range(eventhub_t* hub, eventhub_event_type_t first, eventhub_event_type_t last,
+                               eventhub_subscriber_cb cb) 
+{
+    if (hub == NULL || cb == NULL) 
+        return false;
+
+    if (!eventhub_port_mutex_lock(hub->priv.mutex, 0))
+    {
+        EVENTHUB_LOG("eventhub: mutex lock failed\n");
+        return false;
+    }
+
+    for (uint16_t r = 0; r < hub->priv.range_count; r++) 
+    {
+        uint16_t module = hub->priv.range_subscribers[r].module;
+        if (hub->priv.range_subscribers[r].first == first &&
+            hub->priv.range_subscribers[r].last == last &&
+            hub->priv.module_subscribers[module].cb == cb) 
+        {
+            // 删除表项并保持有序
+            for (uint16_t j = r + 1; j < hub->priv.range_count; j++) 
+            {
+                hub->priv.range_subscribers[j - 1] = hub->priv.range_subscribers[j];
+            }
+            hub->priv.range_count--;
+            adjust_range_cursors(hub, r, -1);
+            update_range_coverage(hub, module);
+
+            // 如果该模块不再订阅任何事件，则完全取消订阅
+            release_module_ref(hub, module);
+
+            eventhub_port_mutex_unlock(hub->priv.mutex);
+            EVENTHUB_LOG("eventhub: unsubscribe range %d-%d\n", first, last);
+            return true;
+        }
+    }
+
+    eventhub_port_mutex_unlock(hub->priv.mutex);
+    EVENTHUB_LOG("eventhub: unsubscribe range failed (not found)\n");
+    return false;
+}
+
+bool eventhub_subscribe_group(eventhub_t* hub, uint32_t group,
+                             eventhub_subscriber_cb cb, void* user_data) 
+{
+    eventhub_event_type_t last;
+    if (hub == NULL || !get_group_last(hub, group, &last)) return false;
+    return eventhub_subscribe_range(hub, EVENTHUB_GROUP_FIRST(group), last, cb, user_data);
+}
+
+bool eventhub_unsubscribe_group(eventhub_t* hub, uint32_t group, eventhub_subscriber_cb cb) 
+{
+    eventhub_event_type_t last;
+    if (hub == NULL || !get_group_last(hub, group, &last)) return false;
+    return eventhub_unsubscribe_range(hub, EVENTHUB_GROUP_FIRST(group), last, cb);
+}
+
+bool eventhub_coro_start(eventhub_t* hub, eventhub_coro_t* co, eventhub_coro_fn fn, void* user_data) 
+{
+    if (hub == NULL || co == NULL || fn == NULL) return false;
+
+    if (!eventhub_port_mutex_lock(hub->priv.mutex, 0))
+    {
+        EVENTHUB_LOG("eventhub: mutex lock failed\n");
+        return false;
+    }
+
+    // 查找空位置（同一协程不能重复启动）
+    uint16_t index = hub->priv.config.max_coros;
+    for (uint16_t i = 0; i < hub->priv.config.max_coros; i++) 
+    {
+        if (hub->priv.coros[i] == co) 
+        {
+            eventhub_port_mutex_unlock(hub->priv.mutex);
+            EVENTHUB_LOG("eventhub: coro already started\n");
+            return false;
+        }
+        if (hub->priv.coros[i] == NULL && index == hub->priv.config.max_coros) 
+        {
+            index = i;
+        }
+    }
+    if (index == hub->priv.config.max_coros) 
+    {
+        eventhub_port_mutex_unlock(hub->priv.mutex);
+        EVENTHUB_LOG("eventhub: coro start failed (max coros)\n");
+        return false;
+    }
+
+    memset(co, 0, sizeof(eventhub_coro_t));
+    co->fn = fn;
+    co->user_data = user_data;
+    hub->priv.coros[index] = co;
+    hub->priv.coro_count++;
+
+    // 执行到第一个等待点
+    run_coro(hub, index, NULL, false);
+
+#if EVENTHUB_USING_RTOS
+    // 处理任务可能正在永久等待，唤醒它按新的截止时间重新计算等待时间（队列非空时无需唤醒）
+    if (hub->priv.coros[index] == co && co->has_deadline) 
+    {
+        eventhub_event_t wakeup = { EVENTHUB_WAKEUP_EVENT, 0, NULL, 0 };
+        (void)eventhub_port_queue_send(hub->priv.queue, &wakeup, 0);
+    }
+#endif
+
+    eventhub_port_mutex_unlock(hub->priv.mutex);
+    EVENTHUB_LOG("eventhub: coro started\n");
+    return true;
+}
+
+bool eventhub_coro_stop(eventhub_t* hub, eventhub_coro_t* co) 
+{
+    if (hub == NULL || co == NULL) return false;
+
+    if (!eventhub_port_mutex_lock(hub->priv.mutex, 0))
+    {
+        EVENTHUB_LOG("eventhub: mutex lock failed\n");
+        return false;
+    }
+
+    for (uint16_t i = 0; i < hub->priv.config.max_coros; i++) 
+    {
+        if (hub->priv.coros[i] == co) 
+        {
+            hub->priv.coros[i] = NULL;
+            hub->priv.coro_count--;
+            eventhub_port_mutex_unlock(hub->priv.mutex);
+            EVENTHUB_LOG("eventhub: coro stopped\n");
+            return true;
+        }
+    }
+
+    eventhub_port_mutex_unlock(hub->priv.mutex);
+    EVENTHUB_LOG("eventhub: coro stop failed (not found)\n");
+    return false;
+}
+
+void eventhub_coro_await(eventhub_coro_t* co, eventhub_event_type_t event_type, uint32_t timeout) 
+{
+    co->wait_type = event_type;
+    co->has_deadline = (timeout != EVENTHUB_WAIT_FOREVER);
+    co->deadline = eventhub_port_get_timestamp() + timeout;
+}
+
+#if EVENTHUB_USING_RTOS
+// 辅助函数：按类型优先级将事件放入队列
+static bool queue_event(eventhub_t* hub, const eventhub_type_props_t* props, 
+                        const eventhub_event_t* event, uint32_t timeout) 
+{
+    if (props != NULL && (props->flags & EVENTHUB_TYPE_FLAG_PRIORITY)) 
+    {
+        return eventhub_port_queue_send_front(hub->priv.queue, event, timeout);
+    }
+    return eventhub_port_queue_send(hub->priv.queue, event, timeout);
+}
+#endif
+
 bool eventhub_publish(eventhub_t* hub, const eventhub_event_t* event, uint32_t timeout) 
 {
     if (hub == NULL || event == NULL) return false;
 
+    // 按类型属性校验负载（常数时间查表）
+    const eventhub_type_props_t* props = get_type_props(hub, event->type);
+    if (props != NULL && 
+        (event->data_len != props->payload_size || (props->payload_size != 0 && event->data == NULL))) 
+    {
+        EVENTHUB_LOG("eventhub: publish event %d failed (payload mismatch)\n", event->type);
+        return false;
+    }
+
     // 填充时间戳
     eventhub_event_t event_with_ts = *event;
     event_with_ts.timestamp = eventhub_port_get_timestamp();
 
 #if EVENTHUB_USING_RTOS
     // RTOS环境：事件放入队列，由eventhub_process任务处理
-    bool ret = eventhub_port_queue_send(hub->priv.queue, &event_with_ts, timeout);
+    bool ret;
+    uint8_t slot = get_type_slot(hub, props, EVENTHUB_TYPE_FLAG_COALESCED);
+    if (slot != EVENTHUB_TYPE_NO_SLOT) 
+    {
+        // 合并类型：检查与入队在同一把锁内完成，只有同类型事件确实在队列中时才合并
+        if (!eventhub_port_mutex_lock(hub->priv.coalesce_mutex, timeout))
+        {
+            EVENTHUB_LOG("eventhub: mutex lock failed\n");
+            return false;
+        }
+        if (hub->priv.coalesce_queued[slot]) 
+        {
+            // 覆盖队列中事件的内容，出队时分发最新值
+            hub->priv.coalesced[slot] = event_with_ts;
+            eventhub_port_mutex_unlock(hub->priv.coalesce_mutex);
+            EVENTHUB_LOG("eventhub: publish event %d (coalesced)\n", event->type);
+            return true;
+        }
+        ret = queue_event(hub, props, &event_with_ts, timeout);
+        if (ret) 
+        {
+            hub->priv.coalesced[slot] = event_with_ts;
+            hub->priv.coalesce_queued[slot] = true;
+        }
+        eventhub_port_mutex_unlock(hub->priv.coalesce_mutex);
+    } 
+    else 
+    {
+        ret = queue_event(hub, props, &event_with_ts, timeout);
+    }
+
     if (ret) 
     {
         EVENTHUB_LOG("eventhub: publish event %d (queued)\n", event->type);
@@ -198,15 +928,7 @@ bool eventhub_publish(eventhub_t* hub, const eventhub_event_t* event, uint32_t t
     }
     
     // 处理所有订阅该事件类型的模块
-    for (uint16_t i = 0; i < EVENTHUB_MAX_MODULES; i++) 
-    {
-        if (hub->priv.module_subscribers[i].in_use &&
-            is_event_set(hub->priv.module_subscribers[i].event_mask, event->type)) 
-        {
-            // 调用模块的回调函数
-            hub->priv.module_subscribers[i].cb(&event_with_ts, hub->priv.module_subscribers[i].user_data);
-        }
-    }
+    dispatch_event(hub, &event_with_ts);
     
     eventhub_port_mutex_unlock(hub->priv.mutex);
     EVENTHUB_LOG("eventhub: publish event %d (sync)\n", event->type);
@@ -216,7 +938,6 @@ bool eventhub_publish(eventhub_t* hub, const eventhub_event_t* event, uint32_t t
 
 void eventhub_process(eventhub_t* hub, uint32_t timeout) 
 {
-#if EVENTHUB_USING_RTOS
     // 参数验证
     if (hub == NULL) 
     {
@@ -224,38 +945,61 @@ void eventhub_process(eventhub_t* hub, uint32_t timeout)
         return;
     }
 
+#if EVENTHUB_USING_RTOS
+    // 有协程等待超时时，队列等待不超过最早的截止时间
+    if (!eventhub_port_mutex_lock(hub->priv.mutex, EVENTHUB_PORT_MAX_DELAY))
+    {
+        EVENTHUB_LOG("eventhub: mutex lock failed during process\n");
+        return;
+    }
+    timeout = limit_wait_timeout(hub, timeout);
+    eventhub_port_mutex_unlock(hub->priv.mutex);
+
     // RTOS环境：从队列取事件并分发（通常在独立任务中运行）
     eventhub_event_t event;
-    if (eventhub_port_queue_receive(hub->priv.queue, &event, timeout))
+    bool received = eventhub_port_queue_receive(hub->priv.queue, &event, timeout) &&
+                    event.type != EVENTHUB_WAKEUP_EVENT;
+    if (received)
     {
         EVENTHUB_LOG("eventhub: received event %d from queue\n", event.type);
-        
-        // 检查互斥锁是否成功获取
-        if (!eventhub_port_mutex_lock(hub->priv.mutex, 0))
-        {
-            EVENTHUB_LOG("eventhub: mutex lock failed during process\n");
-            return;
-        }
-        
-        // 遍历模块订阅者，调用回调
-        for (uint16_t i = 0; i < EVENTHUB_MAX_MODULES; i++) 
+
+        // 合并类型：取出期间被覆盖的最新值，之后的发布重新入队
+        uint8_t slot = get_type_slot(hub, get_type_props(hub, event.type), EVENTHUB_TYPE_FLAG_COALESCED);
+        if (slot != EVENTHUB_TYPE_NO_SLOT && 
+            eventhub_port_mutex_lock(hub->priv.coalesce_mutex, EVENTHUB_PORT_MAX_DELAY)) 
         {
-            if (hub->priv.module_subscribers[i].in_use &&
-                is_event_set(hub->priv.module_subscribers[i].event_mask, event.type)) 
+            // 槽中的值须属于同一类型（属性表重新注册前入队的事件可能映射到其他类型占用的槽）
+            if (hub->priv.coalesce_queued[slot] && hub->priv.coalesced[slot].type == event.type) 
             {
-                if (hub->priv.module_subscribers[i].cb != NULL) 
-                {
-                    hub->priv.module_subscribers[i].cb(&event, hub->priv.module_subscribers[i].user_data);
-                }
+                event = hub->priv.coalesced[slot];
+                hub->priv.coalesce_queued[slot] = false;
             }
+            eventhub_port_mutex_unlock(hub->priv.coalesce_mutex);
         }
-        eventhub_port_mutex_unlock(hub->priv.mutex);
     }
 #else
-    // 裸机环境：空实现（发布时已同步处理）
-    (void)hub;
+    // 裸机环境：事件在发布时已同步处理，这里只检查协程超时
     (void)timeout;
 #endif
+
+    // 已出队的事件必须分发，等待其他任务订阅/取消订阅完成后再获取锁，避免事件丢失
+    if (!eventhub_port_mutex_lock(hub->priv.mutex, EVENTHUB_PORT_MAX_DELAY))
+    {
+        EVENTHUB_LOG("eventhub: mutex lock failed during process\n");
+        return;
+    }
+
+#if EVENTHUB_USING_RTOS
+    if (received) 
+    {
+        // 遍历模块订阅者，调用回调
+        dispatch_event(hub, &event);
+    }
+#endif
+
+    // 恢复等待超时的协程
+    check_coro_timeouts(hub);
+    eventhub_port_mutex_unlock(hub->priv.mutex);
 }
 
 void eventhub_destroy(eventhub_t* hub) 
@@ -264,8 +1008,24 @@ void eventhub_destroy(eventhub_t* hub)
     eventhub_port_mutex_destroy(hub->priv.mutex);
 #if EVENTHUB_USING_RTOS
     eventhub_port_queue_destroy(hub->priv.queue);
+    eventhub_port_mutex_destroy(hub->priv.coalesce_mutex);
+#endif
+
+#if EVENTHUB_DEFAULT_HUBS > 0
+    // 归还默认内存区（未占用时不做处理，初始化失败后销毁也安全）
+    int owned = get_default_arena(hub);
+    if (owned >= 0) 
+    {
+        default_arena_used[owned] = false;
+    }
 #endif
 
-    // 清理模块订阅者信息
-    memset(&hub->priv.module_subscribers, 0, sizeof(hub->priv.module_subscribers));
+    // 清理订阅者信息（内存区归调用者所有，中枢不再引用；EVENTHUB_DEFINE的绑定保留，可再次初始化）
+    void* bound_arena = has_bound_arena(hub) ? hub->priv.bound_arena : NULL;
+    memset(hub, 0, sizeof(eventhub_t));
+    if (bound_arena != NULL) 
+    {
+        hub->priv.bound_arena = bound_arena;
+        hub->priv.bound_magic = EVENTHUB_BOUND_MAGIC;
+    }
 }
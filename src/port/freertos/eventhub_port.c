@@ -37,6 +37,11 @@ eventhub_timestamp_t eventhub_port_get_timestamp(void)
     return xTaskGetTickCount() * portTICK_PERIOD_MS;
 }
 
+uint32_t eventhub_port_ms_to_ticks(uint32_t ms) 
+{
+    return (ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+}
+
 // FreeRTOS队列实现
 eventhub_queue_t* eventhub_port_queue_init(uint32_t item_size, uint32_t queue_len)
 {
@@ -50,6 +55,13 @@ bool eventhub_port_queue_send(eventhub_queue_t* queue, const void* data, uint32_
     return xQueueSend(queue, data, timeout) == pdPASS;
 }
 
+bool eventhub_port_queue_send_front(eventhub_queue_t* queue, const void* data, uint32_t timeout) 
+{
+    if (queue == NULL || data == NULL) return false;
+    
+    return xQueueSendToFront(queue, data, timeout) == pdPASS;
+}
+
 bool eventhub_port_queue_receive(eventhub_queue_t* queue, void* data, uint32_t timeout) 
 {
     if (queue == NULL || data == NULL) return false;
@@ -0,0 +1,243 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "eventhub_port.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+// POSIX适配层（Linux/macOS主机测试用），超时单位：1 tick = 1 ms
+
+// 辅助函数：计算从现在起timeout毫秒后的绝对时间（CLOCK_REALTIME，供timedlock/timedwait使用）
+static void get_deadline(struct timespec* ts, uint32_t timeout) 
+{
+    clock_gettime(CLOCK_REALTIME, ts);
+    ts->tv_sec += timeout / 1000;
+    ts->tv_nsec += (long)(timeout % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) 
+    {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+// POSIX互斥锁实现
+eventhub_mutex_t* eventhub_port_mutex_init(void)
+{
+    pthread_mutex_t* mutex = malloc(sizeof(pthread_mutex_t));
+    if (mutex == NULL) return NULL;
+
+    if (pthread_mutex_init(mutex, NULL) != 0) 
+    {
+        free(mutex);
+        return NULL;
+    }
+    return (eventhub_mutex_t*)mutex;
+}
+
+bool eventhub_port_mutex_lock(eventhub_mutex_t* mutex, uint32_t timeout) 
+{
+    if (mutex == NULL) return false;
+
+    if (timeout == 0) 
+    {
+        return pthread_mutex_trylock((pthread_mutex_t*)mutex) == 0;
+    }
+    if (timeout == EVENTHUB_PORT_MAX_DELAY) 
+    {
+        return pthread_mutex_lock((pthread_mutex_t*)mutex) == 0;
+    }
+
+    struct timespec deadline;
+    get_deadline(&deadline, timeout);
+    return pthread_mutex_timedlock((pthread_mutex_t*)mutex, &deadline) == 0;
+}
+
+void eventhub_port_mutex_unlock(eventhub_mutex_t* mutex) 
+{
+    if (mutex == NULL) return;
+    
+    pthread_mutex_unlock((pthread_mutex_t*)mutex);
+}
+
+void eventhub_port_mutex_destroy(eventhub_mutex_t* mutex) 
+{
+    if (mutex == NULL) return;
+    
+    pthread_mutex_destroy((pthread_mutex_t*)mutex);
+    free(mutex);
+}
+
+// 时间戳：CLOCK_MONOTONIC（ms）
+eventhub_timestamp_t eventhub_port_get_timestamp(void) 
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (eventhub_timestamp_t)((uint64_t)ts.tv_sec * 1000U + (uint64_t)ts.tv_nsec / 1000000U);
+}
+
+#if EVENTHUB_USING_RTOS
+// 超时单位即毫秒（1 tick = 1 ms）
+uint32_t eventhub_port_ms_to_ticks(uint32_t ms) 
+{
+    return ms;
+}
+
+// 有界环形队列（互斥锁 + 条件变量）
+typedef struct 
+{
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    uint32_t item_size;
+    uint32_t queue_len;
+    uint32_t head;
+    uint32_t count;
+    uint8_t* items;
+} posix_queue_t;
+
+// 辅助函数：等待条件成立（调用前需持有队列锁），超时返回false
+static bool wait_for(posix_queue_t* q, pthread_cond_t* cond, bool (*ready)(const posix_queue_t*), uint32_t timeout) 
+{
+    if (ready(q)) return true;
+    if (timeout == 0) return false;
+
+    struct timespec deadline;
+    if (timeout != EVENTHUB_PORT_MAX_DELAY) 
+    {
+        get_deadline(&deadline, timeout);
+    }
+    while (!ready(q)) 
+    {
+        if (timeout == EVENTHUB_PORT_MAX_DELAY) 
+        {
+            pthread_cond_wait(cond, &q->lock);
+        }
+        else if (pthread_cond_timedwait(cond, &q->lock, &deadline) == ETIMEDOUT) 
+        {
+            return ready(q);
+        }
+    }
+    return true;
+}
+
+static bool has_space(const posix_queue_t* q) 
+{
+    return q->count < q->queue_len;
+}
+
+static bool has_item(const posix_queue_t* q) 
+{
+    return q->count > 0;
+}
+
+// 辅助函数：入队（front=true时插入队头）
+static bool queue_put(eventhub_queue_t* queue, const void* data, uint32_t timeout, bool front) 
+{
+    if (queue == NULL || data == NULL) return false;
+
+    posix_queue_t* q = (posix_queue_t*)queue;
+    pthread_mutex_lock(&q->lock);
+    if (!wait_for(q, &q->not_full, has_space, timeout)) 
+    {
+        pthread_mutex_unlock(&q->lock);
+        return false;
+    }
+
+    uint32_t index;
+    if (front) 
+    {
+        q->head = (q->head + q->queue_len - 1) % q->queue_len;
+        index = q->head;
+    }
+    else 
+    {
+        index = (q->head + q->count) % q->queue_len;
+    }
+    memcpy(q->items + (size_t)index * q->item_size, data, q->item_size);
+    q->count++;
+
+    pthread_cond_signal(&q->not_empty);
+    pthread_mutex_unlock(&q->lock);
+    return true;
+}
+
+eventhub_queue_t* eventhub_port_queue_init(uint32_t item_size, uint32_t queue_len)
+{
+    if (item_size == 0 || queue_len == 0) return NULL;
+
+    posix_queue_t* q = calloc(1, sizeof(posix_queue_t));
+    if (q == NULL) return NULL;
+
+    q->items = malloc((size_t)item_size * queue_len);
+    if (q->items == NULL) 
+    {
+        free(q);
+        return NULL;
+    }
+    q->item_size = item_size;
+    q->queue_len = queue_len;
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->not_empty, NULL);
+    pthread_cond_init(&q->not_full, NULL);
+    return q;
+}
+
+bool eventhub_port_queue_send(eventhub_queue_t* queue, const void* data, uint32_t timeout) 
+{
+    return queue_put(queue, data, timeout, false);
+}
+
+bool eventhub_port_queue_send_front(eventhub_queue_t* queue, const void* data, uint32_t timeout) 
+{
+    return queue_put(queue, data, timeout, true);
+}
+
+bool eventhub_port_queue_receive(eventhub_queue_t* queue, void* data, uint32_t timeout) 
+{
+    if (queue == NULL || data == NULL) return false;
+
+    posix_queue_t* q = (posix_queue_t*)queue;
+    pthread_mutex_lock(&q->lock);
+    if (!wait_for(q, &q->not_empty, has_item, timeout)) 
+    {
+        pthread_mutex_unlock(&q->lock);
+        return false;
+    }
+
+    memcpy(data, q->items + (size_t)q->head * q->item_size, q->item_size);
+    q->head = (q->head + 1) % q->queue_len;
+    q->count--;
+
+    pthread_cond_signal(&q->not_full);
+    pthread_mutex_unlock(&q->lock);
+    return true;
+}
+
+void eventhub_port_queue_destroy(eventhub_queue_t* queue) 
+{
+    if (queue == NULL) return;
+
+    posix_queue_t* q = (posix_queue_t*)queue;
+    pthread_cond_destroy(&q->not_full);
+    pthread_cond_destroy(&q->not_empty);
+    pthread_mutex_destroy(&q->lock);
+    free(q->items);
+    free(q);
+}
+#endif
+
+#if EVENTHUB_ENABLE_LOG
+// 日志输出：标准错误输出
+#include <stdio.h>
+#include <stdarg.h>
+
+void eventhub_port_log(const char* format, ...) 
+{
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+#endif
@@ -0,0 +1,200 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "eventhub.h"
+#include "eventhub_coro.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * 协程等待测试（POSIX适配层，RTOS模式）
+ *
+ * 覆盖压力测试中没有的协程等待路径。检查：
+ *   1. 保留事件发布后才启动的协程，等待该类型时在启动中立即恢复（不超时）
+ *   2. 循环等待同一保留类型的协程每个保留事件只恢复一次，不会用同一事件反复恢复（空转）
+ *   3. 分发线程以EVENTHUB_PORT_MAX_DELAY阻塞时启动带超时的等待，协程按时超时恢复
+ *      （启动时唤醒分发线程，等待时间被最近的超时截止时间限制）
+ */
+
+#define EVT_STATE        1               // 保留类型
+#define EVT_LINK         2               // 普通类型（协程等待但不发布）
+#define EVT_STOP         3               // 唤醒分发线程退出
+#define EVT_TYPE_COUNT   4
+
+#define LOOP_MAX_HITS    16              // 循环协程的恢复次数上限，空转时提前退出而不是挂死
+#define TIMEOUT_MS       50              // 超时等待时间
+#define TIMEOUT_LIMIT_MS 1000            // 超过该时间仍未超时恢复视为失败
+
+static eventhub_t g_hub;
+EVENTHUB_ARENA_DEFINE(g_arena, EVENTHUB_ARENA_SIZE(8, 4, 2, 4, 1));
+
+static const eventhub_type_props_t g_type_props[EVT_TYPE_COUNT] =
+{
+    { 0, 0, EVENTHUB_TYPE_NO_SLOT },
+    { 0, EVENTHUB_TYPE_FLAG_DEFINED | EVENTHUB_TYPE_FLAG_RETAINED, 0 },
+    { 0, EVENTHUB_TYPE_FLAG_DEFINED, EVENTHUB_TYPE_NO_SLOT },
+    { 0, EVENTHUB_TYPE_FLAG_DEFINED, EVENTHUB_TYPE_NO_SLOT },
+};
+
+static atomic_bool g_stop_dispatch;
+
+// 协程状态（前两项在主线程中单线程运行，超时协程在分发线程中恢复）
+static uint32_t g_late_resumed;
+static uint32_t g_late_timed_out;
+static uint32_t g_loop_hits;
+static atomic_bool g_timeout_resumed;
+static atomic_bool g_timeout_timed_out;
+static atomic_ullong g_timeout_at;
+
+static uint64_t now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000U + (uint64_t)ts.tv_nsec / 1000000U;
+}
+
+static void sleep_ms(uint32_t ms)
+{
+    struct timespec ts = { (time_t)(ms / 1000U), (long)(ms % 1000U) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static bool publish_type(eventhub_event_type_t type)
+{
+    eventhub_event_t event = { .type = type };
+    return eventhub_publish(&g_hub, &event, 0);
+}
+
+// 保留事件发布之后才启动，等待应立即完成
+static EVENTHUB_CORO(late_coro)
+{
+    EVENTHUB_CORO_BEGIN();
+    EVENTHUB_AWAIT(EVT_STATE, TIMEOUT_LIMIT_MS);
+    g_late_resumed++;
+    g_late_timed_out += EVENTHUB_CORO_TIMED_OUT() ? 1U : 0U;
+    EVENTHUB_CORO_END();
+}
+
+// 循环等待同一保留类型
+static EVENTHUB_CORO(loop_coro)
+{
+    EVENTHUB_CORO_BEGIN();
+    while (g_loop_hits < LOOP_MAX_HITS)
+    {
+        EVENTHUB_AWAIT(EVT_STATE, EVENTHUB_WAIT_FOREVER);
+        g_loop_hits++;
+    }
+    EVENTHUB_CORO_END();
+}
+
+// 等待不会发布的事件，只能超时恢复
+static EVENTHUB_CORO(timeout_coro)
+{
+    EVENTHUB_CORO_BEGIN();
+    EVENTHUB_AWAIT(EVT_LINK, TIMEOUT_MS);
+    atomic_store(&g_timeout_timed_out, EVENTHUB_CORO_TIMED_OUT());
+    atomic_store(&g_timeout_at, now_ms());
+    atomic_store(&g_timeout_resumed, true);
+    EVENTHUB_CORO_END();
+}
+
+static void* dispatcher_main(void* arg)
+{
+    (void)arg;
+    while (!atomic_load(&g_stop_dispatch))
+    {
+        eventhub_process(&g_hub, EVENTHUB_PORT_MAX_DELAY);
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    const eventhub_config_t config =
+    {
+        .max_modules = 8,
+        .queue_size = 16,
+        .max_event_types = 4,
+        .max_range_subs = 2,
+        .max_coros = 4,
+        .max_type_slots = 1
+    };
+    if (!eventhub_init_static(&g_hub, &config, g_arena, sizeof(g_arena)) ||
+        !eventhub_set_type_table(&g_hub, g_type_props, EVT_TYPE_COUNT))
+    {
+        fprintf(stderr, "FAIL: eventhub_init_static\n");
+        return 1;
+    }
+
+    int failures = 0;
+#define CHECK(cond, ...) \
+    do \
+    { \
+        if (!(cond)) \
+        { \
+            fprintf(stderr, "FAIL: " __VA_ARGS__); \
+            failures++; \
+        } \
+    } while (0)
+
+    // 1. 保留事件已存在时启动协程
+    static eventhub_coro_t late;
+    CHECK(publish_type(EVT_STATE), "publish retained event\n");
+    eventhub_process(&g_hub, 0);
+    CHECK(eventhub_coro_start(&g_hub, &late, late_coro, NULL), "start late coroutine\n");
+    CHECK(g_late_resumed == 1 && g_late_timed_out == 0,
+          "late coroutine resumed %u times (%u timed out), expected once by the retained event\n",
+          g_late_resumed, g_late_timed_out);
+
+    // 2. 循环等待同一保留类型：启动时补发一次，之后只在新的保留事件到达时恢复
+    static eventhub_coro_t loop;
+    CHECK(eventhub_coro_start(&g_hub, &loop, loop_coro, NULL), "start loop coroutine\n");
+    CHECK(g_loop_hits == 1, "loop coroutine resumed %u times on start, expected 1\n", g_loop_hits);
+    for (int idle = 0; idle < 3; idle++)
+    {
+        eventhub_process(&g_hub, 0);
+    }
+    CHECK(g_loop_hits == 1, "loop coroutine resumed %u times without a new event, expected 1\n", g_loop_hits);
+    CHECK(publish_type(EVT_STATE), "publish retained event\n");
+    eventhub_process(&g_hub, 0);
+    CHECK(g_loop_hits == 2, "loop coroutine resumed %u times after a second event, expected 2\n", g_loop_hits);
+
+    // 3. 分发线程永久阻塞时启动带超时的等待（循环协程仍在永久等待）
+    pthread_t dispatcher;
+    if (pthread_create(&dispatcher, NULL, dispatcher_main, NULL) != 0)
+    {
+        fprintf(stderr, "FAIL: pthread_create\n");
+        return 1;
+    }
+    sleep_ms(20);
+
+    static eventhub_coro_t timeout;
+    uint64_t start = now_ms();
+    CHECK(eventhub_coro_start(&g_hub, &timeout, timeout_coro, NULL), "start timeout coroutine\n");
+    while (!atomic_load(&g_timeout_resumed) && now_ms() - start < TIMEOUT_LIMIT_MS)
+    {
+        sleep_ms(1);
+    }
+    uint64_t elapsed = atomic_load(&g_timeout_resumed) ? atomic_load(&g_timeout_at) - start : 0;
+    CHECK(atomic_load(&g_timeout_resumed), "timeout coroutine not resumed within %u ms\n", TIMEOUT_LIMIT_MS);
+    CHECK(!atomic_load(&g_timeout_resumed) || (atomic_load(&g_timeout_timed_out) && elapsed + 1 >= TIMEOUT_MS),
+          "timeout coroutine resumed after %llu ms (timed out %d), expected a timeout after %u ms\n",
+          (unsigned long long)elapsed, (int)atomic_load(&g_timeout_timed_out), TIMEOUT_MS);
+
+    atomic_store(&g_stop_dispatch, true);
+    while (!publish_type(EVT_STOP))
+    {
+        sleep_ms(1);
+    }
+    pthread_join(dispatcher, NULL);
+    CHECK(g_loop_hits == 2, "loop coroutine resumed %u times while waiting for the timeout, expected 2\n",
+          g_loop_hits);
+
+    printf("coro: retained start %u, retained loop %u, timeout after %llu ms\n",
+           g_late_resumed, g_loop_hits, (unsigned long long)elapsed);
+
+    eventhub_destroy(&g_hub);
+    printf("coro: %s\n", failures == 0 ? "PASS" : "FAIL");
+    return failures == 0 ? 0 : 1;
+}
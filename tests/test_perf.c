@@ -0,0 +1,323 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "eventhub.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * 吞吐量与延迟回归测试（POSIX适配层，RTOS模式）
+ *
+ * 单个发布线程阻塞发布，分发线程回调中记录“发布->回调”延迟。每轮先运行一次参考流水线
+ * （同样深度的适配层队列 + 直接调用同样数量的回调，不经过中枢），再运行一次中枢，
+ * 以二者之比衡量中枢本身的开销，使结果不随机器快慢和负载变化。重复多轮取中位数后与基线比较：
+ * 吞吐量比低于 基线*(1-throughput_tolerance) 或 p99延迟比高于 基线*(1+p99_tolerance) 时失败
+ * （默认容差0.2/0.5，约为多次运行间波动的两倍）。
+ *
+ * 用法：test_perf [--events N] [--reps N] [--baseline FILE] [--write-baseline FILE]
+ */
+
+#define EVT_PERF     1
+#define FANOUT       8                   // 订阅同一事件的模块数量
+#define MAX_REPS     31
+
+EVENTHUB_DEFINE(g_hub);
+static eventhub_queue_t* g_ref_queue;
+static uint32_t g_events = 50000;
+static uint32_t g_reps = 5;
+static uint64_t* g_send_ns;              // 按序号记录发布时间
+static uint64_t* g_latency_ns;           // 按序号记录回调时间与发布时间之差
+static volatile uint32_t g_fanout_counts[FANOUT];
+static atomic_uint g_received;
+static atomic_bool g_stop;
+
+typedef struct
+{
+    double throughput_eps;
+    double p50_us;
+    double p99_us;
+    double p999_us;
+} perf_result_t;
+
+typedef struct
+{
+    double throughput_ratio;             // 中枢吞吐量 / 参考吞吐量
+    double p99_ratio;                    // 中枢p99延迟 / 参考p99延迟
+    double throughput_tolerance;
+    double p99_tolerance;
+} perf_baseline_t;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+// 第一个订阅者记录延迟，其余订阅者模拟同一事件的扇出开销
+static void latency_cb(const eventhub_event_t* event, void* user_data)
+{
+    (void)user_data;
+    g_latency_ns[event->data_len] = now_ns() - g_send_ns[event->data_len];
+    atomic_fetch_add_explicit(&g_received, 1, memory_order_release);
+}
+
+static void fanout_cb(const eventhub_event_t* event, void* user_data)
+{
+    (void)event;
+    (*(volatile uint32_t*)user_data)++;
+}
+
+static void* dispatcher_main(void* arg)
+{
+    (void)arg;
+    while (!atomic_load(&g_stop))
+    {
+        eventhub_process(&g_hub, 5);
+    }
+    return NULL;
+}
+
+// 参考流水线：直接从适配层队列取事件并依次调用回调
+static void* reference_main(void* arg)
+{
+    (void)arg;
+    eventhub_event_t event;
+    while (!atomic_load(&g_stop))
+    {
+        if (!eventhub_port_queue_receive(g_ref_queue, &event, 5)) continue;
+
+        latency_cb(&event, NULL);
+        for (uint32_t i = 1; i < FANOUT; i++)
+        {
+            fanout_cb(&event, (void*)&g_fanout_counts[i]);
+        }
+    }
+    return NULL;
+}
+
+static int compare_u64(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static int compare_double(const void* a, const void* b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile_us(const uint64_t* sorted, uint32_t count, double p)
+{
+    uint32_t index = (uint32_t)(p * (count - 1));
+    return (double)sorted[index] / 1000.0;
+}
+
+static double median(double* values, uint32_t count)
+{
+    qsort(values, count, sizeof(double), compare_double);
+    return (count % 2) ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) / 2.0;
+}
+
+// 运行一轮：reference为true时运行参考流水线，否则经过中枢
+static bool run_once(bool reference, perf_result_t* result)
+{
+    atomic_store(&g_received, 0);
+    atomic_store(&g_stop, false);
+    memset(g_latency_ns, 0, g_events * sizeof(uint64_t));
+
+    if (reference)
+    {
+        g_ref_queue = eventhub_port_queue_init(sizeof(eventhub_event_t), EVENTHUB_QUEUE_SIZE);
+        if (g_ref_queue == NULL) return false;
+    }
+    else
+    {
+        if (!eventhub_init(&g_hub)) return false;
+        eventhub_subscribe(&g_hub, EVT_PERF, latency_cb, NULL);
+        for (uint32_t i = 1; i < FANOUT; i++)
+        {
+            eventhub_subscribe(&g_hub, EVT_PERF, fanout_cb, (void*)&g_fanout_counts[i]);
+        }
+    }
+
+    pthread_t consumer;
+    pthread_create(&consumer, NULL, reference ? reference_main : dispatcher_main, NULL);
+
+    bool ok = true;
+    uint64_t start = now_ns();
+    for (uint32_t seq = 0; seq < g_events && ok; seq++)
+    {
+        eventhub_event_t event = { .type = EVT_PERF, .data = NULL, .data_len = seq };
+        g_send_ns[seq] = now_ns();
+        if (reference)
+        {
+            event.timestamp = eventhub_port_get_timestamp();
+            ok = eventhub_port_queue_send(g_ref_queue, &event, EVENTHUB_PORT_MAX_DELAY);
+        }
+        else
+        {
+            ok = eventhub_publish(&g_hub, &event, EVENTHUB_PORT_MAX_DELAY);
+        }
+        if (!ok)
+        {
+            fprintf(stderr, "FAIL: blocking publish failed at %u\n", seq);
+        }
+    }
+    while (ok && atomic_load_explicit(&g_received, memory_order_acquire) < g_events)
+    {
+        struct timespec ts = { 0, 100000 };
+        nanosleep(&ts, NULL);
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    atomic_store(&g_stop, true);
+    pthread_join(consumer, NULL);
+    if (reference)
+    {
+        eventhub_port_queue_destroy(g_ref_queue);
+    }
+    else
+    {
+        eventhub_destroy(&g_hub);
+    }
+    if (!ok) return false;
+
+    qsort(g_latency_ns, g_events, sizeof(uint64_t), compare_u64);
+    result->throughput_eps = (double)g_events * 1e9 / (double)elapsed;
+    result->p50_us = percentile_us(g_latency_ns, g_events, 0.50);
+    result->p99_us = percentile_us(g_latency_ns, g_events, 0.99);
+    result->p999_us = percentile_us(g_latency_ns, g_events, 0.999);
+    return true;
+}
+
+static bool read_baseline(const char* path, perf_baseline_t* baseline)
+{
+    FILE* f = fopen(path, "r");
+    if (f == NULL) return false;
+
+    *baseline = (perf_baseline_t){ 0, 0, 0.2, 0.5 };
+    char key[64];
+    double value;
+    char line[256];
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        if (line[0] == '#' || sscanf(line, "%63s %lf", key, &value) != 2) continue;
+
+        if (strcmp(key, "throughput_ratio") == 0) baseline->throughput_ratio = value;
+        else if (strcmp(key, "p99_ratio") == 0) baseline->p99_ratio = value;
+        else if (strcmp(key, "throughput_tolerance") == 0) baseline->throughput_tolerance = value;
+        else if (strcmp(key, "p99_tolerance") == 0) baseline->p99_tolerance = value;
+    }
+    fclose(f);
+    return baseline->throughput_ratio > 0 && baseline->p99_ratio > 0;
+}
+
+static bool write_baseline(const char* path, double throughput_ratio, double p99_ratio)
+{
+    FILE* f = fopen(path, "w");
+    if (f == NULL) return false;
+
+    fprintf(f, "# eventhub 主机性能基线（由 make perf-baseline 生成）\n");
+    fprintf(f, "# 数值为中枢相对同一轮参考流水线（适配层队列 + 直接调用回调）的比值，取多轮中位数\n");
+    fprintf(f, "# 吞吐量比低于 throughput_ratio*(1-throughput_tolerance) 或 p99延迟比高于 p99_ratio*(1+p99_tolerance) 时测试失败\n");
+    fprintf(f, "throughput_ratio %.3f\n", throughput_ratio);
+    fprintf(f, "p99_ratio %.3f\n", p99_ratio);
+    fprintf(f, "throughput_tolerance 0.2\n");
+    fprintf(f, "p99_tolerance 0.5\n");
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    const char* baseline_path = NULL;
+    const char* write_path = NULL;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--events") == 0) g_events = (uint32_t)strtoul(argv[i + 1], NULL, 0);
+        else if (strcmp(argv[i], "--reps") == 0) g_reps = (uint32_t)strtoul(argv[i + 1], NULL, 0);
+        else if (strcmp(argv[i], "--baseline") == 0) baseline_path = argv[i + 1];
+        else if (strcmp(argv[i], "--write-baseline") == 0) write_path = argv[i + 1];
+    }
+    if (g_events == 0 || g_reps == 0 || g_reps > MAX_REPS)
+    {
+        fprintf(stderr, "FAIL: --events must be > 0 and --reps within 1..%d\n", MAX_REPS);
+        return 1;
+    }
+
+    g_send_ns = calloc(g_events, sizeof(uint64_t));
+    g_latency_ns = calloc(g_events, sizeof(uint64_t));
+    if (g_send_ns == NULL || g_latency_ns == NULL)
+    {
+        fprintf(stderr, "FAIL: out of memory\n");
+        return 1;
+    }
+
+    double throughput_ratios[MAX_REPS];
+    double p99_ratios[MAX_REPS];
+    for (uint32_t rep = 0; rep < g_reps; rep++)
+    {
+        perf_result_t ref, hub;
+        if (!run_once(true, &ref) || !run_once(false, &hub))
+        {
+            fprintf(stderr, "FAIL: run %u\n", rep);
+            return 1;
+        }
+        throughput_ratios[rep] = hub.throughput_eps / ref.throughput_eps;
+        p99_ratios[rep] = hub.p99_us / (ref.p99_us > 0.1 ? ref.p99_us : 0.1);
+        printf("perf: run %u: hub %.0f events/s, p50 %.1f us, p99 %.1f us, p99.9 %.1f us | "
+               "reference %.0f events/s, p99 %.1f us | ratio %.3f / %.3f\n",
+               rep, hub.throughput_eps, hub.p50_us, hub.p99_us, hub.p999_us,
+               ref.throughput_eps, ref.p99_us, throughput_ratios[rep], p99_ratios[rep]);
+    }
+
+    double throughput_ratio = median(throughput_ratios, g_reps);
+    double p99_ratio = median(p99_ratios, g_reps);
+    printf("perf: %u events x %d subscribers, median of %u runs: throughput ratio %.3f, p99 ratio %.3f\n",
+           g_events, FANOUT, g_reps, throughput_ratio, p99_ratio);
+
+    if (write_path != NULL)
+    {
+        if (!write_baseline(write_path, throughput_ratio, p99_ratio))
+        {
+            fprintf(stderr, "FAIL: cannot write %s\n", write_path);
+            return 1;
+        }
+        printf("perf: baseline written to %s\n", write_path);
+    }
+
+    if (baseline_path == NULL) return 0;
+
+    perf_baseline_t baseline;
+    if (!read_baseline(baseline_path, &baseline))
+    {
+        fprintf(stderr, "FAIL: cannot read baseline %s\n", baseline_path);
+        return 1;
+    }
+
+    int failures = 0;
+    double min_throughput = baseline.throughput_ratio * (1.0 - baseline.throughput_tolerance);
+    double max_p99 = baseline.p99_ratio * (1.0 + baseline.p99_tolerance);
+    if (throughput_ratio < min_throughput)
+    {
+        fprintf(stderr, "FAIL: throughput ratio %.3f below %.3f (baseline %.3f)\n",
+                throughput_ratio, min_throughput, baseline.throughput_ratio);
+        failures++;
+    }
+    if (p99_ratio > max_p99)
+    {
+        fprintf(stderr, "FAIL: p99 latency ratio %.3f above %.3f (baseline %.3f)\n",
+                p99_ratio, max_p99, baseline.p99_ratio);
+        failures++;
+    }
+    printf("perf: %s (limits: throughput ratio >= %.3f, p99 ratio <= %.3f)\n", failures == 0 ? "PASS" : "FAIL",
+           min_throughput, max_p99);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,521 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "eventhub.h"
+#include "eventhub_coro.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * 多线程压力测试（POSIX适配层，RTOS模式）
+ *
+ * 多个发布线程并发发布，多个抖动线程反复订阅/取消订阅，回调中重入中枢。检查：
+ *   1. 不丢事件：审计订阅者收到的事件数 == 发布成功数（发布失败单独计数）
+ *   2. 每个发布者的事件按发布顺序到达
+ *   3. 取消订阅返回后不再收到回调
+ *   4. 回调中重入订阅返回失败而不是死锁，重入发布的事件同样满足1、2
+ *   5. 合并类型（属性表注册）：每个发布者的值严格递增，最后收到的是某个发布者最后一次发布的值
+ *      （发布成功的最新值不会丢失）
+ *   6. 优先级类型（插入队列头部，相互之间不保证顺序）：收到的事件数和序号之和与发布成功的一致
+ */
+
+#define EVT_DATA         1               // 发布线程发布
+#define EVT_ECHO         2               // 审计回调中重入发布
+#define EVT_CHURN        3               // 抖动线程订阅的类型（精确或范围）
+#define EVT_COALESCED    4               // 合并类型（带负载）
+#define EVT_PRIORITY     5               // 优先级类型（带负载）
+#define EVT_TYPE_COUNT   6
+
+#define PUBLISHERS       8
+#define POLICY_PUBLISHERS 2              // 合并类型、优先级类型各自的发布线程数
+#define POLICY_YIELD_EVERY 4             // 合并/优先级发布线程每N次发布让出一次CPU
+#define CHURNERS         4
+#define ECHO_PUBLISHER   PUBLISHERS      // 重入发布者编号
+#define ECHO_EVERY       16              // 每N个数据事件重入发布一次
+#define RESUB_EVERY      64              // 每N个数据事件重入订阅一次
+
+// 事件数据中携带发布者编号（data）和序号（data_len），不依赖负载内存的生命周期
+#define EVENT_PUBLISHER(e) ((uint32_t)(uintptr_t)(e)->data)
+#define EVENT_SEQ(e)       ((e)->data_len)
+
+// 合并/优先级类型的负载（发布前预先生成，生命周期覆盖整个测试）
+typedef struct
+{
+    uint32_t publisher;
+    uint32_t seq;
+} stress_sample_t;
+
+static eventhub_t g_hub;
+EVENTHUB_ARENA_DEFINE(g_arena, EVENTHUB_ARENA_SIZE(32, 16, 8, 2, 1));
+
+// 事件类型属性表：只定义合并类型和优先级类型，其余类型不校验负载
+static const eventhub_type_props_t g_type_props[EVT_TYPE_COUNT] =
+{
+    { 0, 0, EVENTHUB_TYPE_NO_SLOT },
+    { 0, 0, EVENTHUB_TYPE_NO_SLOT },
+    { 0, 0, EVENTHUB_TYPE_NO_SLOT },
+    { 0, 0, EVENTHUB_TYPE_NO_SLOT },
+    { sizeof(stress_sample_t), EVENTHUB_TYPE_FLAG_DEFINED | EVENTHUB_TYPE_FLAG_COALESCED, 0 },
+    { sizeof(stress_sample_t), EVENTHUB_TYPE_FLAG_DEFINED | EVENTHUB_TYPE_FLAG_PRIORITY, EVENTHUB_TYPE_NO_SLOT },
+};
+
+static uint32_t g_events_per_publisher = 20000;
+static atomic_bool g_stop_churn;
+static atomic_bool g_stop_dispatch;
+
+// 审计订阅者状态（只在分发线程中修改，join之后由主线程读取）
+static uint32_t g_expected_seq[PUBLISHERS + 1];
+static uint32_t g_order_errors;
+static uint32_t g_reentrant_subscribe_ok;
+static uint32_t g_echo_published;
+static uint32_t g_echo_dropped;
+static atomic_ulong g_data_received;
+static atomic_ulong g_echo_received;
+static uint32_t g_coro_hits;
+static uint32_t g_coalesced_next[POLICY_PUBLISHERS];
+static uint32_t g_coalesced_received;
+static uint32_t g_coalesced_order_errors;
+static stress_sample_t g_coalesced_last = { POLICY_PUBLISHERS, 0 };
+static atomic_ulong g_priority_received;
+static uint64_t g_priority_seq_sum;
+
+// 发布线程统计
+typedef struct
+{
+    uint32_t id;
+    eventhub_event_type_t type;
+    stress_sample_t* samples;            // 合并/优先级类型按序号取负载，数据类型为NULL
+    uint32_t published;
+    uint32_t dropped;
+    pthread_t thread;
+} publisher_t;
+
+// 抖动线程状态
+typedef struct
+{
+    atomic_bool active;                  // 订阅期间为true，取消订阅返回后置false
+    atomic_ulong calls;
+    atomic_ulong violations;             // 取消订阅返回后仍收到的回调
+    unsigned long cycles;
+    unsigned long retries;
+    pthread_t thread;
+} churner_t;
+
+static churner_t g_churners[CHURNERS];
+
+static void check_order(const eventhub_event_t* event)
+{
+    uint32_t publisher = EVENT_PUBLISHER(event);
+    if (publisher > PUBLISHERS || EVENT_SEQ(event) != g_expected_seq[publisher])
+    {
+        g_order_errors++;
+        if (publisher <= PUBLISHERS)
+        {
+            g_expected_seq[publisher] = EVENT_SEQ(event) + 1;
+        }
+        return;
+    }
+    g_expected_seq[publisher]++;
+}
+
+static void audit_cb(const eventhub_event_t* event, void* user_data)
+{
+    (void)user_data;
+    check_order(event);
+
+    if (event->type == EVT_ECHO)
+    {
+        atomic_fetch_add(&g_echo_received, 1);
+        return;
+    }
+
+    unsigned long received = atomic_fetch_add(&g_data_received, 1) + 1;
+
+    // 重入发布：分发线程不能等待自己的队列，使用非阻塞发布，失败计入丢弃
+    if (received % ECHO_EVERY == 0)
+    {
+        eventhub_event_t echo =
+        {
+            .type = EVT_ECHO,
+            .data = (void*)(uintptr_t)ECHO_PUBLISHER,
+            .data_len = g_echo_published
+        };
+        if (eventhub_publish(&g_hub, &echo, 0))
+        {
+            g_echo_published++;
+        }
+        else
+        {
+            g_echo_dropped++;
+        }
+    }
+
+    // 重入订阅：分发期间持有互斥锁，必须立即失败而不是死锁
+    if (received % RESUB_EVERY == 0 && eventhub_subscribe(&g_hub, EVT_CHURN, audit_cb, NULL))
+    {
+        g_reentrant_subscribe_ok++;
+    }
+}
+
+// 合并/优先级类型订阅者（精确订阅合并类型，同时用范围订阅覆盖两种类型，验证只回调一次）
+static void policy_cb(const eventhub_event_t* event, void* user_data)
+{
+    (void)user_data;
+    const stress_sample_t* sample = (const stress_sample_t*)event->data;
+    if (sample->publisher >= POLICY_PUBLISHERS)
+    {
+        g_coalesced_order_errors++;
+        return;
+    }
+
+    if (event->type == EVT_COALESCED)
+    {
+        // 合并只会跳过中间值，不会出现旧值或重复值
+        if (sample->seq < g_coalesced_next[sample->publisher])
+        {
+            g_coalesced_order_errors++;
+        }
+        g_coalesced_next[sample->publisher] = sample->seq + 1;
+        g_coalesced_last = *sample;
+        g_coalesced_received++;
+    }
+    else
+    {
+        g_priority_seq_sum += sample->seq;
+        atomic_fetch_add(&g_priority_received, 1);
+    }
+}
+
+static void churn_check(churner_t* churner)
+{
+    atomic_fetch_add(&churner->calls, 1);
+    if (!atomic_load(&churner->active))
+    {
+        atomic_fetch_add(&churner->violations, 1);
+    }
+}
+
+// 取消订阅只按回调函数匹配，每个抖动线程需要独立的回调
+#define CHURN_CB(n) \
+    static void churn_cb_##n(const eventhub_event_t* event, void* user_data) \
+    { \
+        (void)event; \
+        churn_check((churner_t*)user_data); \
+    }
+CHURN_CB(0)
+CHURN_CB(1)
+CHURN_CB(2)
+CHURN_CB(3)
+
+static const eventhub_subscriber_cb g_churn_cbs[CHURNERS] = { churn_cb_0, churn_cb_1, churn_cb_2, churn_cb_3 };
+
+// 协程订阅者：持续等待重入发布的事件
+static EVENTHUB_CORO(echo_coro)
+{
+    EVENTHUB_CORO_BEGIN();
+    while (1)
+    {
+        EVENTHUB_AWAIT(EVT_ECHO, EVENTHUB_WAIT_FOREVER);
+        g_coro_hits++;
+    }
+    EVENTHUB_CORO_END();
+}
+
+static void* publisher_main(void* arg)
+{
+    publisher_t* publisher = (publisher_t*)arg;
+    uint32_t attempts = 0;
+
+    while (publisher->published < g_events_per_publisher)
+    {
+        eventhub_event_t event =
+        {
+            .type = publisher->type,
+            .data = (void*)(uintptr_t)publisher->id,
+            .data_len = publisher->published
+        };
+        if (publisher->samples != NULL)
+        {
+            event.data = &publisher->samples[publisher->published];
+            event.data_len = sizeof(stress_sample_t);
+        }
+        // 交替使用非阻塞和短超时发布，失败时序号不变，下次重试同一序号
+        uint32_t timeout = (attempts++ % 2 == 0) ? 0 : 2;
+        if (eventhub_publish(&g_hub, &event, timeout))
+        {
+            publisher->published++;
+            // 合并类型连续发布时几乎全部被合并，定期让出CPU使分发线程交替取出
+            if (publisher->samples != NULL && publisher->published % POLICY_YIELD_EVERY == 0)
+            {
+                sched_yield();
+            }
+        }
+        else
+        {
+            publisher->dropped++;
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void* churner_main(void* arg)
+{
+    churner_t* churner = (churner_t*)arg;
+    eventhub_subscriber_cb cb = g_churn_cbs[churner - g_churners];
+
+    while (!atomic_load(&g_stop_churn))
+    {
+        // 交替使用精确订阅和覆盖EVT_DATA的范围订阅
+        bool use_range = (churner->cycles % 2) != 0;
+
+        atomic_store(&churner->active, true);
+        while (!(use_range ? eventhub_subscribe_range(&g_hub, EVT_DATA, EVT_CHURN, cb, churner)
+                           : eventhub_subscribe(&g_hub, EVT_DATA, cb, churner)))
+        {
+            churner->retries++;
+            sched_yield();
+        }
+
+        sched_yield();
+
+        while (!(use_range ? eventhub_unsubscribe_range(&g_hub, EVT_DATA, EVT_CHURN, cb)
+                           : eventhub_unsubscribe(&g_hub, EVT_DATA, cb)))
+        {
+            churner->retries++;
+            sched_yield();
+        }
+        atomic_store(&churner->active, false);
+        churner->cycles++;
+    }
+    return NULL;
+}
+
+static void* dispatcher_main(void* arg)
+{
+    (void)arg;
+    while (!atomic_load(&g_stop_dispatch))
+    {
+        eventhub_process(&g_hub, 5);
+    }
+    return NULL;
+}
+
+static uint64_t now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000U + (uint64_t)ts.tv_nsec / 1000000U;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1)
+    {
+        g_events_per_publisher = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+
+    const eventhub_config_t config =
+    {
+        .max_modules = 32,
+        .queue_size = 64,
+        .max_event_types = 16,
+        .max_range_subs = 8,
+        .max_coros = 2,
+        .max_type_slots = 1
+    };
+    if (!eventhub_init_static(&g_hub, &config, g_arena, sizeof(g_arena)) ||
+        !eventhub_set_type_table(&g_hub, g_type_props, EVT_TYPE_COUNT))
+    {
+        fprintf(stderr, "FAIL: eventhub_init_static\n");
+        return 1;
+    }
+
+    // 审计订阅者：精确订阅EVT_DATA，同时用范围订阅覆盖EVT_DATA~EVT_ECHO，验证同一事件只回调一次
+    static eventhub_coro_t coro;
+    if (!eventhub_subscribe(&g_hub, EVT_DATA, audit_cb, NULL) ||
+        !eventhub_subscribe_range(&g_hub, EVT_DATA, EVT_ECHO, audit_cb, NULL) ||
+        !eventhub_coro_start(&g_hub, &coro, echo_coro, NULL) ||
+        !eventhub_subscribe(&g_hub, EVT_COALESCED, policy_cb, NULL) ||
+        !eventhub_subscribe_range(&g_hub, EVT_COALESCED, EVT_PRIORITY, policy_cb, NULL))
+    {
+        fprintf(stderr, "FAIL: initial subscribe\n");
+        return 1;
+    }
+
+    pthread_t dispatcher;
+    publisher_t publishers[PUBLISHERS];
+    publisher_t coalesced_publishers[POLICY_PUBLISHERS];
+    publisher_t priority_publishers[POLICY_PUBLISHERS];
+    for (uint32_t i = 0; i < POLICY_PUBLISHERS; i++)
+    {
+        coalesced_publishers[i] = (publisher_t){ .id = i, .type = EVT_COALESCED };
+        priority_publishers[i] = (publisher_t){ .id = i, .type = EVT_PRIORITY };
+        coalesced_publishers[i].samples = calloc(g_events_per_publisher, sizeof(stress_sample_t));
+        priority_publishers[i].samples = calloc(g_events_per_publisher, sizeof(stress_sample_t));
+        if (coalesced_publishers[i].samples == NULL || priority_publishers[i].samples == NULL)
+        {
+            fprintf(stderr, "FAIL: out of memory\n");
+            return 1;
+        }
+        for (uint32_t seq = 0; seq < g_events_per_publisher; seq++)
+        {
+            coalesced_publishers[i].samples[seq] = (stress_sample_t){ i, seq };
+            priority_publishers[i].samples[seq] = (stress_sample_t){ i, seq };
+        }
+    }
+    pthread_create(&dispatcher, NULL, dispatcher_main, NULL);
+    for (uint32_t i = 0; i < CHURNERS; i++)
+    {
+        pthread_create(&g_churners[i].thread, NULL, churner_main, &g_churners[i]);
+    }
+    uint64_t start = now_ms();
+    for (uint32_t i = 0; i < PUBLISHERS; i++)
+    {
+        publishers[i] = (publisher_t){ .id = i, .type = EVT_DATA };
+        pthread_create(&publishers[i].thread, NULL, publisher_main, &publishers[i]);
+    }
+    for (uint32_t i = 0; i < POLICY_PUBLISHERS; i++)
+    {
+        pthread_create(&coalesced_publishers[i].thread, NULL, publisher_main, &coalesced_publishers[i]);
+        pthread_create(&priority_publishers[i].thread, NULL, publisher_main, &priority_publishers[i]);
+    }
+
+    unsigned long published = 0;
+    unsigned long dropped = 0;
+    for (uint32_t i = 0; i < PUBLISHERS; i++)
+    {
+        pthread_join(publishers[i].thread, NULL);
+        published += publishers[i].published;
+        dropped += publishers[i].dropped;
+    }
+    unsigned long coalesced_published = 0;
+    unsigned long priority_published = 0;
+    uint64_t priority_seq_sum = 0;
+    for (uint32_t i = 0; i < POLICY_PUBLISHERS; i++)
+    {
+        pthread_join(coalesced_publishers[i].thread, NULL);
+        pthread_join(priority_publishers[i].thread, NULL);
+        coalesced_published += coalesced_publishers[i].published;
+        priority_published += priority_publishers[i].published;
+        dropped += coalesced_publishers[i].dropped + priority_publishers[i].dropped;
+        priority_seq_sum += (uint64_t)priority_publishers[i].published * (priority_publishers[i].published - 1) / 2;
+    }
+
+    // 等待分发线程处理完所有已发布的事件
+    uint64_t deadline = now_ms() + 30000;
+    while ((atomic_load(&g_data_received) < published || atomic_load(&g_priority_received) < priority_published) &&
+           now_ms() < deadline)
+    {
+        struct timespec ts = { 0, 1000000 };
+        nanosleep(&ts, NULL);
+    }
+    uint64_t elapsed = now_ms() - start;
+
+    atomic_store(&g_stop_churn, true);
+    for (uint32_t i = 0; i < CHURNERS; i++)
+    {
+        pthread_join(g_churners[i].thread, NULL);
+    }
+    atomic_store(&g_stop_dispatch, true);
+    pthread_join(dispatcher, NULL);
+
+    // 分发线程退出后在主线程中处理剩余的重入事件和合并事件
+    for (int idle = 0; idle < 100; idle++)
+    {
+        bool coalesced_done = g_coalesced_last.publisher < POLICY_PUBLISHERS &&
+                              g_coalesced_last.seq + 1 == coalesced_publishers[g_coalesced_last.publisher].published;
+        if (atomic_load(&g_echo_received) >= g_echo_published && coalesced_done) break;
+        eventhub_process(&g_hub, 1);
+    }
+
+    // 分发线程已退出，合并类型连续发布两次：第二次覆盖队列中的事件，只收到最新值
+    stress_sample_t coalesced_last = g_coalesced_last;
+    static stress_sample_t tail_samples[2];
+    uint32_t tail_received = g_coalesced_received;
+    bool tail_published = true;
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        tail_samples[i] = (stress_sample_t){ 0, g_events_per_publisher + i };
+        eventhub_event_t event = { .type = EVT_COALESCED, .data = &tail_samples[i], .data_len = sizeof(stress_sample_t) };
+        tail_published = eventhub_publish(&g_hub, &event, 0) && tail_published;
+    }
+    for (int idle = 0; idle < 10; idle++)
+    {
+        eventhub_process(&g_hub, 0);
+    }
+    tail_received = g_coalesced_received - tail_received;
+
+    unsigned long churn_calls = 0;
+    unsigned long churn_violations = 0;
+    unsigned long churn_cycles = 0;
+    unsigned long churn_retries = 0;
+    for (uint32_t i = 0; i < CHURNERS; i++)
+    {
+        churn_calls += atomic_load(&g_churners[i].calls);
+        churn_violations += atomic_load(&g_churners[i].violations);
+        churn_cycles += g_churners[i].cycles;
+        churn_retries += g_churners[i].retries;
+    }
+
+    printf("stress: %lu events in %llu ms, %lu publish failures (counted), %u echo (%u dropped)\n",
+           published, (unsigned long long)elapsed, dropped, g_echo_published, g_echo_dropped);
+    printf("stress: %lu churn cycles, %lu churn callbacks, %lu lock retries\n",
+           churn_cycles, churn_calls, churn_retries);
+    printf("stress: %lu coalesced published, %u delivered; %lu priority published\n",
+           coalesced_published, g_coalesced_received, priority_published);
+
+    int failures = 0;
+#define CHECK(cond, ...) \
+    do \
+    { \
+        if (!(cond)) \
+        { \
+            fprintf(stderr, "FAIL: " __VA_ARGS__); \
+            failures++; \
+        } \
+    } while (0)
+
+    CHECK(atomic_load(&g_data_received) == published, "lost events: received %lu, published %lu\n",
+          atomic_load(&g_data_received), published);
+    CHECK(atomic_load(&g_echo_received) == g_echo_published, "lost echo events: received %lu, published %u\n",
+          atomic_load(&g_echo_received), g_echo_published);
+    CHECK(g_coro_hits == g_echo_published, "coroutine resumed %u times, expected %u\n",
+          g_coro_hits, g_echo_published);
+    CHECK(g_order_errors == 0, "%u per-publisher order violations\n", g_order_errors);
+    for (uint32_t i = 0; i < PUBLISHERS; i++)
+    {
+        CHECK(g_expected_seq[i] == publishers[i].published, "publisher %u: last seq %u, published %u\n",
+              i, g_expected_seq[i], publishers[i].published);
+    }
+    CHECK(churn_violations == 0, "%lu callbacks after unsubscribe returned\n", churn_violations);
+    CHECK(g_reentrant_subscribe_ok == 0, "re-entrant subscribe succeeded %u times while dispatching\n",
+          g_reentrant_subscribe_ok);
+    CHECK(g_coalesced_order_errors == 0, "%u stale, duplicate or invalid coalesced/priority events\n",
+          g_coalesced_order_errors);
+    CHECK(g_coalesced_received > 0 && g_coalesced_received <= coalesced_published,
+          "coalesced events delivered %u times, published %lu\n", g_coalesced_received, coalesced_published);
+    CHECK(coalesced_last.publisher < POLICY_PUBLISHERS &&
+          coalesced_last.seq + 1 == coalesced_publishers[coalesced_last.publisher].published,
+          "last coalesced value (publisher %u, seq %u) is not a final published value\n",
+          coalesced_last.publisher, coalesced_last.seq);
+    CHECK(tail_published && tail_received == 1 && g_coalesced_last.seq == g_events_per_publisher + 1,
+          "queued coalesced event not replaced by latest value (delivered %u, last seq %u)\n",
+          tail_received, g_coalesced_last.seq);
+    CHECK(atomic_load(&g_priority_received) == priority_published && g_priority_seq_sum == priority_seq_sum,
+          "lost priority events: received %lu (seq sum %llu), published %lu (seq sum %llu)\n",
+          atomic_load(&g_priority_received), (unsigned long long)g_priority_seq_sum, priority_published,
+          (unsigned long long)priority_seq_sum);
+
+    eventhub_destroy(&g_hub);
+    for (uint32_t i = 0; i < POLICY_PUBLISHERS; i++)
+    {
+        free(coalesced_publishers[i].samples);
+        free(priority_publishers[i].samples);
+    }
+    printf("stress: %s\n", failures == 0 ? "PASS" : "FAIL");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,310 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+eventhub 事件模式代码生成器
+
+读取事件模式文件（.schema），生成包含以下内容的头文件：
+  - 事件ID枚举 <PREFIX>_EVENT_<名称>（未指定ID时按顺序紧凑分配；属性表以ID为下标，ID过于稀疏时给出警告）
+  - 类型安全的 publish/subscribe/unsubscribe 内联封装及负载访问函数
+  - 负载结构体大小的编译期检查（C11 _Static_assert / C++11 static_assert）
+  - 以事件ID为下标的常量属性表（eventhub_type_props_t）及注册函数
+
+生成的头文件可同时被 C 和 C++ 源文件包含。
+
+模式文件格式（# 开头为注释）：
+    prefix  app                     # 生成的枚举/函数/表名前缀
+    include "app_payloads.h"        # 负载结构体所在头文件（可多条）
+
+    # 名称            ID      负载类型[:字节数]     标志（retained/coalesced/priority）
+    VCC_POWER_ON      -       -                     retained
+    LINK_UP           -       link_info_t           priority
+    SENSOR_SAMPLE     -       sensor_sample_t:8     coalesced
+
+用法：
+    python3 tools/eventhub_gen.py events.schema -o app_events.h
+"""
+
+import argparse
+import os
+import re
+import sys
+
+FLAGS = {
+    "retained": "EVENTHUB_TYPE_FLAG_RETAINED",
+    "coalesced": "EVENTHUB_TYPE_FLAG_COALESCED",
+    "priority": "EVENTHUB_TYPE_FLAG_PRIORITY",
+}
+# 需要占用策略槽的标志
+SLOT_FLAGS = ("retained", "coalesced")
+
+NAME_RE = re.compile(r"^[A-Z][A-Z0-9_]*$")
+# 与生成的 <PREFIX>_EVENT_TYPE_COUNT / <PREFIX>_EVENT_SLOT_COUNT 同名的事件名
+RESERVED_NAMES = ("TYPE_COUNT", "SLOT_COUNT")
+IDENT_RE = re.compile(r"^[A-Za-z_][A-Za-z0-9_]*$")
+
+
+class SchemaError(Exception):
+    pass
+
+
+class Event(object):
+    def __init__(self, name, event_id, payload, payload_size, flags, line):
+        self.name = name
+        self.id = event_id
+        self.payload = payload
+        self.payload_size = payload_size
+        self.flags = flags
+        self.line = line
+        self.slot = None
+
+
+def parse_schema(path):
+    prefix = None
+    includes = []
+    events = []
+    next_id = 0
+
+    with open(path, "r", encoding="utf-8") as f:
+        for lineno, raw in enumerate(f, 1):
+            line = raw.split("#", 1)[0].strip()
+            if not line:
+                continue
+            fields = line.split()
+            where = "%s:%d" % (path, lineno)
+
+            if fields[0] == "prefix":
+                if len(fields) != 2 or not IDENT_RE.match(fields[1]):
+                    raise SchemaError("%s: invalid prefix" % where)
+                prefix = fields[1]
+                continue
+            if fields[0] == "include":
+                if len(fields) != 2:
+                    raise SchemaError("%s: invalid include" % where)
+                includes.append(fields[1].strip('"<>'))
+                continue
+
+            if len(fields) < 3:
+                raise SchemaError("%s: expected 'NAME ID PAYLOAD [FLAGS...]'" % where)
+            name, id_text, payload_text = fields[0], fields[1], fields[2]
+            if not NAME_RE.match(name):
+                raise SchemaError("%s: event name '%s' must be UPPER_SNAKE_CASE" % (where, name))
+            if name in RESERVED_NAMES:
+                raise SchemaError("%s: event name '%s' is reserved" % (where, name))
+
+            if id_text == "-":
+                event_id = next_id
+            else:
+                try:
+                    event_id = int(id_text, 0)
+                except ValueError:
+                    raise SchemaError("%s: invalid id '%s'" % (where, id_text))
+            if event_id < 0:
+                raise SchemaError("%s: negative id" % where)
+            next_id = event_id + 1
+
+            payload, payload_size = None, None
+            if payload_text != "-":
+                payload, _, size_text = payload_text.partition(":")
+                if not IDENT_RE.match(payload):
+                    raise SchemaError("%s: invalid payload type '%s'" % (where, payload))
+                if size_text:
+                    try:
+                        payload_size = int(size_text, 0)
+                    except ValueError:
+                        raise SchemaError("%s: invalid payload size '%s'" % (where, size_text))
+
+            flags = []
+            for flag in fields[3:]:
+                if flag not in FLAGS:
+                    raise SchemaError("%s: unknown flag '%s' (expected %s)"
+                                      % (where, flag, "/".join(FLAGS)))
+                if flag not in flags:
+                    flags.append(flag)
+
+            events.append(Event(name, event_id, payload, payload_size, flags, lineno))
+
+    if prefix is None:
+        raise SchemaError("%s: missing 'prefix' directive" % path)
+    if not events:
+        raise SchemaError("%s: no events defined" % path)
+
+    seen_names, seen_ids = {}, {}
+    for ev in events:
+        if ev.name in seen_names:
+            raise SchemaError("%s:%d: duplicate event name '%s' (first at line %d)"
+                              % (path, ev.line, ev.name, seen_names[ev.name]))
+        if ev.id in seen_ids:
+            raise SchemaError("%s:%d: duplicate id %d (also used by %s)"
+                              % (path, ev.line, ev.id, seen_ids[ev.id].name))
+        seen_names[ev.name] = ev.line
+        seen_ids[ev.id] = ev
+
+    # 按出现顺序分配策略槽
+    slot = 0
+    for ev in events:
+        if any(flag in SLOT_FLAGS for flag in ev.flags):
+            ev.slot = slot
+            slot += 1
+
+    return prefix, includes, events, slot
+
+
+def generate(schema_path, prefix, includes, events, slot_count):
+    guard = "%s_EVENTS_H" % prefix.upper()
+    type_count = "%s_EVENT_TYPE_COUNT" % prefix.upper()
+    table = "%s_event_props" % prefix
+    impl = "%s_EVENTS_IMPLEMENTATION" % prefix.upper()
+    static_assert = "%s_STATIC_ASSERT" % prefix.upper()
+    slot_count_name = "%s_EVENT_SLOT_COUNT" % prefix.upper()
+    # 枚举名同样带前缀，避免多个模式文件或已有的 EVENT_xxx 宏冲突
+    enum_prefix = "%s_EVENT_" % prefix.upper()
+    ordered = sorted(events, key=lambda e: e.id)
+    out = []
+    w = out.append
+
+    w("// 由 tools/eventhub_gen.py 根据 %s 自动生成，请勿手工修改" % os.path.basename(schema_path))
+    w("#ifndef %s" % guard)
+    w("#define %s" % guard)
+    w("")
+    w("#include <stddef.h>")
+    w('#include "eventhub.h"')
+    for inc in includes:
+        w('#include "%s"' % inc)
+    w("")
+    w("#ifdef __cplusplus")
+    w('extern "C" {')
+    w("#endif")
+    w("")
+
+    w("// 事件ID")
+    w("enum")
+    w("{")
+    for ev in ordered:
+        w("    %s%s = %d," % (enum_prefix, ev.name, ev.id))
+    w("    %s = %d   // 属性表项数（最大ID+1），不能超过中枢配置的 max_event_types" % (type_count, ordered[-1].id + 1))
+    w("};")
+    w("")
+    w("// 占用的保留/合并策略槽数量，不能超过中枢配置的 max_type_slots（注册时检查）")
+    w("#define %s %d" % (slot_count_name, slot_count))
+    w("")
+
+    w("// 编译期检查")
+    w("#ifdef __cplusplus")
+    w("#define %s(cond, msg) static_assert(cond, msg)" % static_assert)
+    w("#else")
+    w("#define %s(cond, msg) _Static_assert(cond, msg)" % static_assert)
+    w("#endif")
+    for ev in events:
+        if ev.payload is None:
+            continue
+        if ev.payload_size is not None:
+            w("%s(sizeof(%s) == %d, \"%s: unexpected size of %s\");"
+              % (static_assert, ev.payload, ev.payload_size, ev.name, ev.payload))
+        w("%s(sizeof(%s) <= 0xFFFF, \"%s: payload too large\");" % (static_assert, ev.payload, ev.name))
+    w("")
+
+    w("// 事件类型属性表（在一个源文件中定义 %s 后包含本头文件以生成定义）" % impl)
+    w("extern const eventhub_type_props_t %s[%s];" % (table, type_count))
+    w("")
+    w("#ifdef %s" % impl)
+    w("const eventhub_type_props_t %s[%s] = " % (table, type_count))
+    w("{")
+    # 按ID顺序逐项列出（C++不支持数组指示初始化），未使用的ID填充未定义项
+    by_id = dict((ev.id, ev) for ev in events)
+    for event_id in range(ordered[-1].id + 1):
+        ev = by_id.get(event_id)
+        if ev is None:
+            w("    { 0, 0, EVENTHUB_TYPE_NO_SLOT },   // %d: 未使用" % event_id)
+            continue
+        flags = ["EVENTHUB_TYPE_FLAG_DEFINED"] + [FLAGS[f] for f in ev.flags]
+        size = "sizeof(%s)" % ev.payload if ev.payload else "0"
+        slot = str(ev.slot) if ev.slot is not None else "EVENTHUB_TYPE_NO_SLOT"
+        w("    { %s, %s, %s },   // %s%s" % (size, " | ".join(flags), slot, enum_prefix, ev.name))
+    w("};")
+    w("#endif")
+    w("")
+
+    w("/**")
+    w(" * 向事件中枢注册%s事件属性表" % prefix)
+    w(" * @param hub 事件中枢实例")
+    w(" * @return 成功返回true")
+    w(" */")
+    w("static inline bool %s_events_register(eventhub_t* hub)" % prefix)
+    w("{")
+    w("    return eventhub_set_type_table(hub, %s, %s);" % (table, type_count))
+    w("}")
+
+    for ev in events:
+        lower = ev.name.lower()
+        w("")
+        w("// %s" % ev.name)
+        if ev.payload:
+            w("static inline bool %s_publish_%s(eventhub_t* hub, const %s* payload, uint32_t timeout)"
+              % (prefix, lower, ev.payload))
+            w("{")
+            w("    eventhub_event_t event = { %s%s, 0, (void*)payload, sizeof(%s) };"
+              % (enum_prefix, ev.name, ev.payload))
+        else:
+            w("static inline bool %s_publish_%s(eventhub_t* hub, uint32_t timeout)" % (prefix, lower))
+            w("{")
+            w("    eventhub_event_t event = { %s%s, 0, NULL, 0 };" % (enum_prefix, ev.name))
+        w("    return eventhub_publish(hub, &event, timeout);")
+        w("}")
+        w("")
+        w("static inline bool %s_subscribe_%s(eventhub_t* hub, eventhub_subscriber_cb cb, void* user_data)"
+          % (prefix, lower))
+        w("{")
+        w("    return eventhub_subscribe(hub, %s%s, cb, user_data);" % (enum_prefix, ev.name))
+        w("}")
+        w("")
+        w("static inline bool %s_unsubscribe_%s(eventhub_t* hub, eventhub_subscriber_cb cb)" % (prefix, lower))
+        w("{")
+        w("    return eventhub_unsubscribe(hub, %s%s, cb);" % (enum_prefix, ev.name))
+        w("}")
+        if ev.payload:
+            w("")
+            w("// 回调中获取类型化负载（事件类型或长度不匹配时返回NULL）")
+            w("static inline const %s* %s_payload_%s(const eventhub_event_t* event)"
+              % (ev.payload, prefix, lower))
+            w("{")
+            w("    if (event == NULL || event->type != %s%s || event->data_len != sizeof(%s)) return NULL;"
+              % (enum_prefix, ev.name, ev.payload))
+            w("    return (const %s*)event->data;" % ev.payload)
+            w("}")
+
+    w("")
+    w("#ifdef __cplusplus")
+    w("}")
+    w("#endif")
+    w("")
+    w("#endif")
+    return "\n".join(out) + "\n"
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="eventhub event schema code generator")
+    parser.add_argument("schema", help="event schema file")
+    parser.add_argument("-o", "--output", help="output header (default: <prefix>_events.h next to schema)")
+    args = parser.parse_args(argv)
+
+    try:
+        prefix, includes, events, slot_count = parse_schema(args.schema)
+    except (SchemaError, IOError) as e:
+        sys.stderr.write("eventhub_gen: %s\n" % e)
+        return 1
+
+    # 属性表以事件ID为下标，ID稀疏时大部分表项为空
+    table_size = max(ev.id for ev in events) + 1
+    if len(events) * 2 < table_size:
+        sys.stderr.write("eventhub_gen: warning: %s: %d events use a %d-entry props table, "
+                         "consider '-' ids to keep them dense\n" % (args.schema, len(events), table_size))
+
+    output = args.output or os.path.join(os.path.dirname(args.schema), "%s_events.h" % prefix)
+    text = generate(args.schema, prefix, includes, events, slot_count)
+    with open(output, "w", encoding="utf-8", newline="\n") as f:
+        f.write(text)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))